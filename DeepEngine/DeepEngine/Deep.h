@@ -54,6 +54,8 @@
 
 #define Deep_Unreachable __builtin_unreachable()
 
+#define Deep_Restrict __restrict__
+
 #define Deep__Function__ __func__
 #define Deep__File__ __FILE__
 #define Deep__Line__ __LINE__
@@ -67,6 +69,8 @@
 
 #define Deep_Unreachable __builtin_unreachable()
 
+#define Deep_Restrict __restrict__
+
 #define Deep__Function__ __func__
 #define Deep__File__ __FILE__
 #define Deep__Line__ __LINE__
@@ -80,6 +84,8 @@
 
 #define Deep_Unreachable __assume(0)
 
+#define Deep_Restrict __restrict
+
 #define Deep__Function__ __FUNCTION__
 #define Deep__File__ __FILE__
 #define Deep__Line__ __LINE__
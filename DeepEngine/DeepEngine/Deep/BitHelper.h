@@ -130,6 +130,20 @@ namespace Deep {
 #endif
     }
 
+    inline uint32 NumTrailingZeros(uint64 value) {
+#if (defined(__x86_64__) || defined(_M_X64)) && defined(DEEP_USE_TZCNT)
+        return static_cast<uint32>(_tzcnt_u64(value));
+#elif __cplusplus >= 202002L
+        return static_cast<uint32>(std::countr_zero(value));
+#else
+        uint32 low = static_cast<uint32>(value);
+        if (low != 0) {
+            return NumTrailingZeros(low);
+        }
+        return 32 + NumTrailingZeros(static_cast<uint32>(value >> 32));
+#endif
+    }
+
     Deep_Inline uint32 RotateLeft(const uint32 value, const int32 offset) {
         return (value << offset) | (value >> (32 - offset));
     }
@@ -7,16 +7,26 @@ namespace Deep {
 
     struct ComponentDesc {
         // TODO(randomuserhi): move somewhere else
-        Deep_Inline ComponentDesc(ComponentId id, size_t size, size_t alignment, const char* name);
+        Deep_Inline ComponentDesc(ComponentId id, size_t size, size_t alignment, const char* name,
+                                  size_t fieldSize = 0, size_t lanes = 0);
 
         ComponentId id;
         size_t size;
         size_t alignment;
         const char* name;
+
+        // Layout hint for laned components, which are stored split into fields of `fieldSize` bytes in blocks of
+        // `lanes` entities. A `lanes` of 0 stores the component as an array of whole components.
+        size_t fieldSize;
+        size_t lanes;
     };
 } // namespace Deep
 
 #include "Entity.inl"
 
 #include "Entity/_ECRegistry.h"
-#include "Entity/_ECDB.h"
\ No newline at end of file
+#include "Entity/_ComponentMap.h"
+#include "Entity/_SparseSet.h"
+#include "Entity/_ECDB.h"
+#include "Entity/_ECDBLink.h"
+#include "Entity/_SystemScheduler.h"
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 namespace Deep {
-    ComponentDesc::ComponentDesc(ComponentId id, size_t size, size_t alignment, const char* name) :
-        id(id), size(size), alignment(alignment), name(name) {}
+    ComponentDesc::ComponentDesc(ComponentId id, size_t size, size_t alignment, const char* name, size_t fieldSize,
+                                 size_t lanes) :
+        id(id), size(size), alignment(alignment), name(name), fieldSize(fieldSize), lanes(lanes) {}
 } // namespace Deep
\ No newline at end of file
@@ -0,0 +1,277 @@
+/**
+ * ECDB CommandBuffer
+ */
+
+#include <Deep/Entity.h>
+#include <Deep/Memory.h>
+
+#include <algorithm>
+
+// Class CommandBuffer
+namespace Deep {
+    ECDB::CommandBuffer::~CommandBuffer() {
+        // TODO(randomuserhi): Thread Safety
+        std::vector<CommandBuffer*>& buffers = database->commandBuffers;
+        buffers.erase(std::find(buffers.begin(), buffers.end(), this));
+    }
+
+    ECDB::CommandBuffer::DeferredEntt ECDB::CommandBuffer::Entity(Archetype* archetype) {
+        Deep_Assert(archetype == nullptr || archetype->database == database,
+                    "Archetype does not belong to this command buffer's database.");
+
+        DeferredEntt entity{ numCreated++ };
+        commands.push_back({ CommandType::Create, entity, archetype, 0, 0 });
+        return entity;
+    }
+
+    void ECDB::CommandBuffer::Destroy(DeferredEntt entity) {
+        commands.push_back({ CommandType::Destroy, entity, nullptr, 0, 0 });
+    }
+
+    void ECDB::CommandBuffer::AddComponent(DeferredEntt entity, ComponentId component) {
+        Deep_Assert(database->registry->Has(component), "ComponentId does not exist in registry.");
+        commands.push_back({ CommandType::AddComponent, entity, nullptr, component, 0 });
+    }
+
+    void ECDB::CommandBuffer::RemoveComponent(DeferredEntt entity, ComponentId component) {
+        Deep_Assert(database->registry->Has(component), "ComponentId does not exist in registry.");
+        commands.push_back({ CommandType::RemoveComponent, entity, nullptr, component, 0 });
+    }
+
+    void ECDB::CommandBuffer::SetComponent(DeferredEntt entity, ComponentId component, const void* value) {
+        Deep_Assert(ECRegistry::IsComponent(component) || ECRegistry::IsSparse(component),
+                    "Cannot set the value of a tag.");
+
+        size_t size = database->registry->Get(component).size;
+        size_t offset = data.size();
+
+        data.resize(offset + size);
+        Memcpy(data.data() + offset, value, size);
+
+        commands.push_back({ CommandType::SetComponent, entity, nullptr, component, offset });
+    }
+} // namespace Deep
+
+// Playback
+namespace Deep {
+    void ECDB::Playback(CommandBuffer* const* buffers, size_t numBuffers) {
+        // TODO(randomuserhi): Thread Safety
+
+        // Net result of all commands for a given entity
+        struct Target {
+            // nullptr if the entity is created on playback (until it has been created)
+            EntityPtr* entity;
+
+            // Archetype the entity is in prior playback, nullptr if the entity is created on playback
+            Archetype* source;
+
+            // Archetype the entity ends up in after playback
+            Archetype* destination;
+
+            bool destroyed;
+        };
+
+        struct Write {
+            size_t target;
+            ComponentId component;
+            const uint8* value;
+        };
+
+        // Command on a sparse component, applied in order once all entities exist as they do not move entities
+        struct SparseCommand {
+            size_t target;
+            const CommandBuffer::Command* command;
+            const uint8* value;
+        };
+
+        std::vector<Target> targets;
+        std::vector<Write> writes;
+        std::vector<SparseCommand> sparseCommands;
+
+        // Lookup of existing entities into `targets`
+        std::unordered_map<EntityPtr*, size_t> lookup;
+
+        // Resolve the net result of the commands for each entity
+        for (size_t i = 0; i < numBuffers; ++i) {
+            const CommandBuffer& buffer = *buffers[i];
+            Deep_Assert(buffer.database == this, "Command buffer does not belong to this database.");
+
+            // Index into `targets` for each entity created by this buffer
+            std::vector<size_t> created;
+            created.reserve(buffer.numCreated);
+
+            for (const CommandBuffer::Command& command : buffer.commands) {
+                if (command.type == CommandBuffer::CommandType::Create) {
+                    created.push_back(targets.size());
+                    Archetype* archetype = command.archetype != nullptr ? command.archetype : rootArchetype;
+                    targets.push_back({ nullptr, nullptr, archetype, false });
+                    continue;
+                }
+
+                size_t index;
+                EntityPtr* entity = command.entity.entity;
+                if (entity == nullptr) {
+                    Deep_Assert(command.entity.index < created.size(), "Entity was used prior being created.");
+                    index = created[command.entity.index];
+                } else {
+                    auto it = lookup.find(entity);
+                    if (it != lookup.end()) {
+                        index = it->second;
+                    } else {
+                        Deep_Assert(entity->archetype != nullptr, "Entity does not belong to any archetype.");
+                        index = targets.size();
+                        targets.push_back({ entity, entity->archetype, entity->archetype, false });
+                        lookup.emplace(entity, index);
+                    }
+                }
+
+                Target& target = targets[index];
+                if (target.destroyed) continue;
+
+                if (command.type != CommandBuffer::CommandType::Destroy && ECRegistry::IsSparse(command.component)) {
+                    sparseCommands.push_back({ index, &command, buffer.data.data() + command.dataOffset });
+                    continue;
+                }
+
+                switch (command.type) {
+                case CommandBuffer::CommandType::Destroy:
+                    target.destroyed = true;
+                    break;
+                case CommandBuffer::CommandType::AddComponent:
+                    if (!target.destination->description.HasComponent(command.component)) {
+                        target.destination = GetAddArchetype(target.destination, command.component);
+                    }
+                    break;
+                case CommandBuffer::CommandType::RemoveComponent:
+                    if (target.destination->description.HasComponent(command.component)) {
+                        target.destination = GetRemoveArchetype(target.destination, command.component);
+                    }
+                    break;
+                case CommandBuffer::CommandType::SetComponent:
+                    writes.push_back({ index, command.component, buffer.data.data() + command.dataOffset });
+                    break;
+                default:
+                    Deep_Unreachable;
+                }
+            }
+        }
+
+        // Group structural changes by source -> destination archetype such that entities are moved in batches
+        // NOTE(randomuserhi): Archetypes are ordered by id rather than address, and the sort is stable, such that
+        //                     entities are created, placed and moved in the same order between runs (in the order
+        //                     of their commands within a group).
+        std::vector<size_t> order(targets.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&targets](size_t a, size_t b) {
+            const Target& x = targets[a];
+            const Target& y = targets[b];
+
+            // Created entities (without a source archetype) come first
+            size_t xSource = x.source != nullptr ? x.source->id + 1 : 0;
+            size_t ySource = y.source != nullptr ? y.source->id + 1 : 0;
+            if (xSource != ySource) return xSource < ySource;
+            return x.destination->id < y.destination->id;
+        });
+
+        // Create entities in bulk per destination archetype
+        std::vector<EntityPtr*> batch;
+        for (size_t i = 0; i < order.size();) {
+            Target& first = targets[order[i]];
+            if (first.entity != nullptr) {
+                ++i;
+                continue;
+            }
+
+            size_t end = i;
+            while (end < order.size()) {
+                const Target& target = targets[order[end]];
+                if (target.entity != nullptr || target.destination != first.destination) break;
+                ++end;
+            }
+
+            batch.clear();
+            for (size_t j = i; j < end; ++j) {
+                if (!targets[order[j]].destroyed) batch.push_back(nullptr);
+            }
+            AllocateEntities(batch.data(), batch.size());
+            first.destination->Emplace(batch.data(), batch.size(), nullptr);
+
+            size_t k = 0;
+            for (size_t j = i; j < end; ++j) {
+                Target& target = targets[order[j]];
+                if (!target.destroyed) target.entity = batch[k++];
+            }
+
+            i = end;
+        }
+
+        // Move entities, reusing the transition plan for each source -> destination group
+        // NOTE(randomuserhi): Entities are still moved one at a time (a copy per column followed by a swap-remove from
+        //                     the source), as entities of a group are rarely contiguous in their source chunks.
+        Archetype::TransitionPlan plan;
+        Archetype* planSource = nullptr;
+        Archetype* planDestination = nullptr;
+        for (size_t index : order) {
+            Target& target = targets[index];
+            if (target.destroyed || target.source == nullptr || target.source == target.destination) continue;
+
+            if (target.source != planSource || target.destination != planDestination) {
+                planSource = target.source;
+                planDestination = target.destination;
+                plan = planDestination->GetTransitionPlan(*planSource);
+            }
+
+            target.destination->Move(target.entity, plan);
+        }
+
+        // Apply commands on sparse components
+        for (const SparseCommand& sparse : sparseCommands) {
+            const Target& target = targets[sparse.target];
+            if (target.destroyed) continue;
+
+            ComponentId component = sparse.command->component;
+            uint32 key = GetEntitySlot(target.entity)->index;
+            SparseSet& set = GetSparseSet(component);
+
+            switch (sparse.command->type) {
+            case CommandBuffer::CommandType::AddComponent:
+                if (!set.Has(key)) set.Insert(key);
+                break;
+            case CommandBuffer::CommandType::RemoveComponent:
+                set.Erase(key);
+                break;
+            case CommandBuffer::CommandType::SetComponent: {
+                void* value = set.Find(key);
+                if (value != nullptr) Memcpy(value, sparse.value, registry->Get(component).size);
+                break;
+            }
+            default:
+                Deep_Unreachable;
+            }
+        }
+
+        // Destroy entities
+        for (size_t index : order) {
+            Target& target = targets[index];
+            if (!target.destroyed || target.entity == nullptr) continue;
+
+            Destroy(target.entity);
+        }
+
+        // Write component values
+        for (const Write& write : writes) {
+            const Target& target = targets[write.target];
+            if (target.destroyed || !target.destination->description.HasComponent(write.component)) continue;
+
+            Archetype* archetype = target.destination;
+            Archetype::ComponentOffset offset = archetype->GetComponentOffset(write.component);
+            archetype->WriteComponent(target.entity, offset, write.value);
+        }
+
+        for (size_t i = 0; i < numBuffers; ++i) {
+            buffers[i]->Clear();
+        }
+    }
+} // namespace Deep
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+
+namespace Deep {
+    template<typename T>
+    T* ComponentMap<T>::Find(ComponentId id) {
+        size_t index = IndexOf(id);
+        return index != items.size() ? &items[index].value : nullptr;
+    }
+
+    template<typename T>
+    const T* ComponentMap<T>::Find(ComponentId id) const {
+        size_t index = IndexOf(id);
+        return index != items.size() ? &items[index].value : nullptr;
+    }
+
+    template<typename T>
+    T& ComponentMap<T>::Insert(ComponentId id, T&& value) {
+        Deep_Assert(Find(id) == nullptr, "Component already exists in the map.");
+
+        ComponentId key = ECRegistry::StripTagBit(id);
+        auto it = std::lower_bound(items.begin(), items.end(), key, [](const Entry& entry, ComponentId key) {
+            return ECRegistry::StripTagBit(entry.id) < key;
+        });
+        it = items.insert(it, Entry{ id, std::move(value) });
+        size_t index = it - items.begin();
+
+        Rebuild();
+
+        return items[index].value;
+    }
+
+    template<typename T>
+    bool ComponentMap<T>::Erase(ComponentId id) {
+        size_t index = IndexOf(id);
+        if (index == items.size()) return false;
+
+        items.erase(items.begin() + index);
+        Rebuild();
+
+        return true;
+    }
+
+    template<typename T>
+    const std::vector<typename ComponentMap<T>::Entry>& ComponentMap<T>::entries() const {
+        return items;
+    }
+
+    template<typename T>
+    size_t ComponentMap<T>::size() const {
+        return items.size();
+    }
+
+    template<typename T>
+    size_t ComponentMap<T>::IndexOf(ComponentId id) const {
+        ComponentId key = ECRegistry::StripTagBit(id);
+
+        if (!table.empty()) {
+            // NOTE(randomuserhi): Ids smaller than `base` wrap around to a large index and fail the bounds check.
+            size_t i = static_cast<uint32>(key) - static_cast<uint32>(base);
+            if (i >= table.size() || table[i] == 0) return items.size();
+            return table[i] - 1;
+        }
+
+        // Sparse ids, binary search
+        auto it = std::lower_bound(items.begin(), items.end(), key, [](const Entry& entry, ComponentId key) {
+            return ECRegistry::StripTagBit(entry.id) < key;
+        });
+        if (it == items.end() || ECRegistry::StripTagBit(it->id) != key) return items.size();
+        return it - items.begin();
+    }
+
+    template<typename T>
+    void ComponentMap<T>::Rebuild() {
+        table.clear();
+        if (items.empty()) return;
+
+        base = ECRegistry::StripTagBit(items.front().id);
+        size_t range = static_cast<size_t>(ECRegistry::StripTagBit(items.back().id) - base) + 1;
+        if (range > minTableSize && range > maxSparsity * items.size()) return;
+
+        table.resize(range, 0);
+        for (size_t i = 0; i < items.size(); ++i) {
+            table[ECRegistry::StripTagBit(items[i].id) - base] = static_cast<uint32>(i + 1);
+        }
+    }
+} // namespace Deep
\ No newline at end of file
@@ -6,71 +6,225 @@
 #include <Deep/Math.h>
 #include <Deep/Memory.h>
 
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
 // TODO(randomuserhi): Refactor for readability (don't restructure if-statements based on likelyhood)
 
 namespace Deep {
     ECDB::~ECDB() {
+        // Free forks
+        while (!forks.empty()) {
+            Release(forks.back());
+        }
+
+        // Free queries
+        for (Query* query : queries) {
+            delete query;
+        }
+
+        // Free prefabs
+        for (Prefab* prefab : prefabs) {
+            delete prefab;
+        }
+
         // Free archetypes
         for (const auto& kv : archetypes) {
             delete kv.second;
         }
 
-        // Free entity pages
-        while (entityPages != nullptr) {
-            EntityPage* temp = entityPages;
-            entityPages = entityPages->next;
-            delete entityPages;
+        // Free chunk pools
+        for (const auto& kv : chunkAllocators) {
+            delete kv.second;
         }
 
-        firstFree = nullptr;
+        // Free entity lookup table
+        for (EntitySlot* block : entityBlocks) {
+            delete[] block;
+        }
+
+        // Free sparse sets
+        for (const ComponentMap<SparseSet*>::Entry& entry : sparseSets.entries()) {
+            delete entry.value;
+        }
+    }
+
+    ECDB::EntitySlot* ECDB::NewEntitySlot() {
+        Deep_Assert(numEntitySlots < EntityHandle::maxIndex, "Exceeded the maximum number of entities.");
+
+        if (numEntitySlots % entityBlockSize == 0) {
+            // NOTE(randomuserhi): Slots remain uninitialized until allocated
+            entityBlocks.push_back(new EntitySlot[entityBlockSize]);
+        }
+
+        uint32 index = numEntitySlots++;
+        EntitySlot* slot = &GetEntitySlot(index);
+        slot->index = index;
+        slot->generation = 0;
+
+        return slot;
     }
 
     ECDB::EntityPtr* ECDB::AllocateEntity() {
         // TODO(randomuserhi): Support Concurrency (lock-free)
 
-        EntityPage::Storage* storage;
+        EntitySlot* slot;
 
-        if (firstFree != nullptr) {
+        if (firstFree != noSlot) {
             // Take first item of free list
 
-            storage = firstFree;
-            firstFree = firstFree->next;
+            slot = &GetEntitySlot(firstFree);
+            firstFree = slot->nextFree;
         } else {
             // Free list is empty
 
-            if (entityPages != nullptr) {
-                // Page allocated
+            slot = NewEntitySlot();
+        }
 
-                if (firstFreeItemInNewPage < EntityPage::pageSize) {
-                    // Allocated page has space
+        slot->nextFree = usedSlot;
 
-                    storage = &(entityPages->entityLookup[firstFreeItemInNewPage++]);
-                } else {
-                    // Allocated page is full
+        EntityPtr& ptr = slot->ptr;
+        ptr.archetype = nullptr;
+        ptr.chunk = nullptr;
+
+        if (recordEvents) createdEvents.push_back(EntityHandle{ slot->index, slot->generation });
 
-                    EntityPage* newPage = new EntityPage{};
-                    entityPages = newPage;
+        return &ptr;
+    }
 
-                    storage = &(entityPages->entityLookup[0]);
+    void ECDB::AllocateEntities(EntityPtr** woEntities, size_t count) {
+        // TODO(randomuserhi): Support Concurrency (lock-free)
 
-                    firstFreeItemInNewPage = 1;
-                }
-            } else {
-                // No pages allocated
+        for (size_t i = 0; i < count; ++i) {
+            woEntities[i] = AllocateEntity();
+        }
+    }
 
-                entityPages = new EntityPage{};
+    void ECDB::FreeEntity(EntityPtr* entity) {
+        // TODO(randomuserhi): Support Concurrency (lock-free)
 
-                storage = &(entityPages->entityLookup[firstFreeItemInNewPage++]);
+        static_assert(std::is_standard_layout<EntitySlot>(), "EntitySlot must be of standard layout.");
+
+        EntitySlot* slot = GetEntitySlot(entity);
+        Deep_Assert(slot->nextFree == usedSlot, "Entity has already been freed.");
+
+        if (recordEvents) destroyedEvents.push_back(EntityHandle{ slot->index, slot->generation });
+
+        // Remove sparse components
+        for (const ComponentMap<SparseSet*>::Entry& entry : sparseSets.entries()) {
+            entry.value->Erase(slot->index);
+        }
+
+#ifdef DEEP_ENABLE_ASSERTS
+        entity->archetype = nullptr;
+        entity->chunk = nullptr;
+        entity->index = 0;
+#endif
+
+        slot->generation = (slot->generation + 1) & EntityHandle::generationMask;
+
+        slot->nextFree = firstFree;
+        firstFree = slot->index;
+    }
+
+    void ECDB::Destroy(EntityPtr* entity) {
+        if (entity->archetype != nullptr) {
+            entity->archetype->Deallocate(entity);
+        }
+
+        FreeEntity(entity);
+    }
+
+    void ECDB::DestroyAll(Archetype& archetype) {
+        Deep_Assert(archetype.database == this, "Archetype does not belong to this database.");
+
+        // Release the lookup slot of every entity
+        size_t size = archetype.firstFreeItemInNewChunk;
+        for (Archetype::Chunk* chunk = archetype.tail; chunk != nullptr; chunk = archetype.GetNextChunk(chunk)) {
+            const Archetype::Metadata* metadata = Archetype::GetMetaList(chunk);
+            for (size_t i = 0; i < size; ++i) {
+                FreeEntity(metadata[i].entt);
             }
+
+            size = archetype.entitiesPerChunk;
         }
 
-        storage->next = nullptr;
+        archetype.ReleaseChunks();
+    }
 
-        EntityPtr& ptr = storage->ptr;
-        ptr.archetype = nullptr;
-        ptr.chunk = nullptr;
+    void ECDB::DestroyAll(const Query& query) {
+        for (Archetype* archetype : query.archetypes()) {
+            DestroyAll(*archetype);
+        }
+    }
 
-        return &ptr;
+    size_t ECDB::Trim() {
+        size_t released = 0;
+        for (const auto& kv : chunkAllocators) {
+            released += kv.second->Trim();
+        }
+        return released;
+    }
+
+    bool ECDB::Compact(std::chrono::microseconds budget) {
+        // TODO(randomuserhi): Thread Safety
+
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point deadline = Clock::now() + budget;
+
+        // Archetypes referenced by forks need to remain valid for `Restore`, archetypes of prefabs for
+        // `Prefab::Instantiate`, destination archetypes of links for `ECDBLink::Update` and archetypes of pending
+        // commands for `Playback`
+        std::unordered_set<Archetype*> pinned;
+        for (const ForkState* fork : forks) {
+            for (const ForkState::ArchetypeState& state : fork->archetypes) {
+                pinned.insert(state.archetype);
+            }
+        }
+        for (const Prefab* prefab : prefabs) {
+            pinned.insert(prefab->archetype);
+        }
+        for (const ECDBLink* link : links) {
+            pinned.insert(link->archetype);
+        }
+        for (const CommandBuffer* buffer : commandBuffers) {
+            for (const CommandBuffer::Command& command : buffer->commands) {
+                if (command.archetype != nullptr) pinned.insert(command.archetype);
+            }
+        }
+
+        std::vector<Archetype*> idle;
+        for (const auto& kv : archetypes) {
+            Archetype* archetype = kv.second;
+            if (archetype == rootArchetype || archetype->numEntities != 0) continue;
+            if (pinned.find(archetype) != pinned.end()) continue;
+            idle.push_back(archetype);
+        }
+
+        for (Archetype* archetype : idle) {
+            if (Clock::now() >= deadline) return false;
+            RetireArchetype(archetype);
+        }
+
+        for (const auto& kv : chunkAllocators) {
+            if (Clock::now() >= deadline) return false;
+            kv.second->Trim();
+        }
+
+        return true;
+    }
+
+    SlabAllocator* ECDB::GetChunkAllocator(size_t allocationSize) {
+        // NOTE(randomuserhi): Allocations are rounded to the cache line by the allocator, so sizes that round to the
+        //                     same block size share a pool.
+        size_t blockSize = (allocationSize + DEEP_CACHE_LINE_SIZE - 1) / DEEP_CACHE_LINE_SIZE * DEEP_CACHE_LINE_SIZE;
+
+        SlabAllocator*& allocator = chunkAllocators[blockSize];
+        if (allocator == nullptr) {
+            allocator = new SlabAllocator(blockSize, SlabAllocator::hugePageSize, useHugePages);
+        }
+        return allocator;
     }
 
     ECDB::Entt ECDB::Entity() {
@@ -87,65 +241,132 @@ namespace Deep {
 
         Deep_Assert(entity->archetype != nullptr, "Entity does not belong to any archetype.");
 
-        Archetype* arch = entity->archetype;
-
-        Deep_Assert(!arch->description.HasComponent(component), "Entity already has this component.");
+        if (ECRegistry::IsSparse(component)) {
+            // Sparse components are stored beside the archetype, the entity is not moved
+            GetSparseSet(component).Insert(GetEntitySlot(entity)->index);
+            return;
+        }
 
-        if (arch->addMap.find(component) != arch->addMap.end()) {
-            arch->addMap[component]->Move(entity);
-        } else {
-            // Archetype does not exist
+        Deep_Assert(!entity->archetype->description.HasComponent(component), "Entity already has this component.");
 
-            ArchetypeDesc description{ arch->description };
-            description.AddComponent(component);
+        const Archetype::Edge& edge = GetAddEdge(entity->archetype, component);
+        edge.archetype->Move(entity, edge.plan);
+    }
 
-            // Check if we already have the archetype from a different path
-            if (archetypes.find(description.type) != archetypes.end()) {
-                archetypes[description.type]->Move(entity);
-                return;
-            }
+    void ECDB::RemoveComponent(EntityPtr* entity, ComponentId component) {
+        // TODO(randomuserhi): Thread Safety
 
-            // Create a new archetype
-            Archetype* newArch = new Archetype(this, std::move(description));
-            arch->addMap.emplace(component, newArch);
-            newArch->removeMap.emplace(component, arch);
-            archetypes.emplace(newArch->description.type, newArch);
+        Deep_Assert(entity->archetype != nullptr, "Entity does not belong to any archetype.");
 
-            // Move entity to new archetype
-            newArch->Move(entity);
+        if (ECRegistry::IsSparse(component)) {
+            SparseSet* set = FindSparseSet(component);
+            bool erased = set != nullptr && set->Erase(GetEntitySlot(entity)->index);
+            Deep_Assert(erased, "Entity does not have this component.");
+            return;
         }
+
+        const Archetype::Edge& edge = GetRemoveEdge(entity->archetype, component);
+        edge.archetype->Move(entity, edge.plan);
     }
 
-    void ECDB::RemoveComponent(EntityPtr* entity, ComponentId component) {
+    void ECDB::AddComponent(Archetype& archetype, ComponentId component) {
         // TODO(randomuserhi): Thread Safety
 
-        Deep_Assert(entity->archetype != nullptr, "Entity does not belong to any archetype.");
+        Deep_Assert(!ECRegistry::IsSparse(component), "Sparse components are added per entity.");
+
+        Deep_Assert(!archetype.description.HasComponent(component), "Archetype already has this component.");
+
+        GetAddArchetype(&archetype, component)->Move(archetype);
+    }
+
+    void ECDB::RemoveComponent(Archetype& archetype, ComponentId component) {
+        // TODO(randomuserhi): Thread Safety
+
+        Deep_Assert(!ECRegistry::IsSparse(component), "Sparse components are removed per entity.");
+
+        GetRemoveArchetype(&archetype, component)->Move(archetype);
+    }
+
+    const ECDB::Archetype::Edge& ECDB::GetAddEdge(Archetype* arch, ComponentId component) {
+        // TODO(randomuserhi): Thread Safety
+
+        Deep_Assert(!ECRegistry::IsShared(component), "Shared components are added with SetSharedComponent.");
+
+        const Archetype::Edge* edge = arch->addMap.Find(component);
+        if (edge != nullptr) {
+            return *edge;
+        }
+
+        // Check if we already have the archetype from a different path
+        //
+        // NOTE(randomuserhi): Only the key is derived such that the layout of the description is not copied.
+        ArchetypeKey key = arch->description.GetKey();
+        key.type.AddComponent(component);
 
-        Archetype* arch = entity->archetype;
+        Archetype* existing = FindArchetype(key);
+        if (existing != nullptr) {
+            LinkArchetypes(arch, existing, component);
+            return *arch->addMap.Find(component);
+        }
+
+        // Archetype does not exist, create a new archetype
+
+        ArchetypeDesc description{ arch->description };
+        description.AddComponent(component);
+
+        Archetype* newArch = new Archetype(this, std::move(description));
+        LinkArchetypes(arch, newArch, component);
+        RegisterArchetype(newArch);
 
-        if (arch->removeMap.find(component) != arch->removeMap.end()) {
-            arch->removeMap[component]->Move(entity);
+        return *arch->addMap.Find(component);
+    }
+
+    const ECDB::Archetype::Edge& ECDB::GetRemoveEdge(Archetype* arch, ComponentId component) {
+        // TODO(randomuserhi): Thread Safety
+
+        const Archetype::Edge* edge = arch->removeMap.Find(component);
+        if (edge != nullptr) {
+            return *edge;
+        }
+
+        // Check if we already have the archetype from a different path
+        //
+        // NOTE(randomuserhi): Removing a shared component changes the shared values of the key, so the full
+        //                     description is derived instead.
+        Archetype* existing = nullptr;
+        if (!ECRegistry::IsShared(component)) {
+            ArchetypeKey key = arch->description.GetKey();
+            key.type.RemoveComponent(component);
+            existing = FindArchetype(key);
         } else {
-            // Archetype does not exist
+            existing = FindArchetype(ArchetypeDesc{ arch->description }.RemoveComponent(component));
+        }
+        if (existing != nullptr) {
+            LinkArchetypes(existing, arch, component);
+            return *arch->removeMap.Find(component);
+        }
 
-            ArchetypeDesc description{ arch->description };
-            description.RemoveComponent(component);
+        // Archetype does not exist, create a new archetype
 
-            // Check if we already have the archetype from a different path
-            if (archetypes.find(description.type) != archetypes.end()) {
-                archetypes[description.type]->Move(entity);
-                return;
-            }
+        ArchetypeDesc description{ arch->description };
+        description.RemoveComponent(component);
+
+        Archetype* newArch = new Archetype(this, std::move(description));
+        LinkArchetypes(newArch, arch, component);
+        RegisterArchetype(newArch);
 
-            // Create a new archetype
-            Archetype* newArch = new Archetype(this, std::move(description));
-            arch->removeMap.emplace(component, newArch);
-            newArch->addMap.emplace(component, arch);
-            archetypes.emplace(newArch->description.type, newArch);
+        return *arch->removeMap.Find(component);
+    }
 
-            // Move entity to new archetype
-            newArch->Move(entity);
+    void ECDB::LinkArchetypes(Archetype* arch, Archetype* other, ComponentId component) {
+        // NOTE(randomuserhi): The archetype reached by adding a shared component depends on its value, so only the remove
+        //                     edge is cached.
+        if (!ECRegistry::IsShared(component)) {
+            arch->addMap.Insert(component, Archetype::Edge{ other, other->GetTransitionPlan(*arch) });
+        } else {
+            arch->sharedRemoveEdges.emplace_back(other, component);
         }
+        other->removeMap.Insert(component, Archetype::Edge{ arch, arch->GetTransitionPlan(*other) });
     }
 
     ECDB::Archetype& ECDB::GetArchetype(ComponentId* components, size_t numComponents) {
@@ -155,42 +376,194 @@ namespace Deep {
 
         Archetype* arch = rootArchetype;
         for (size_t i = 0; i < numComponents; ++i) {
-            ComponentId component = components[i];
+            arch = GetAddArchetype(arch, components[i]);
+        }
 
-            if (arch->addMap.find(component) != arch->addMap.end()) {
-                arch = arch->addMap[component];
-            } else {
-                // Archetype does not exist
+        return *arch;
+    }
+
+    ECDB::Archetype& ECDB::GetArchetype(const ArchetypeDesc& description) {
+        // TODO(randomuserhi): Thread Safety
+
+        Archetype* arch = FindArchetype(description);
+        if (arch == nullptr) {
+            arch = new Archetype(this, ArchetypeDesc{ description });
+            RegisterArchetype(arch);
+        }
+
+        return *arch;
+    }
+
+    ECDB::Archetype* ECDB::FindArchetype(const ArchetypeDesc& description) const {
+        return FindArchetype(description.GetKey());
+    }
+
+    SparseSet& ECDB::GetSparseSet(ComponentId component) {
+        Deep_Assert(ECRegistry::IsSparse(component), "Component is not a sparse component.");
+
+        SparseSet* set = FindSparseSet(component);
+        if (set == nullptr) {
+            const ComponentDesc& desc = registry->Get(component);
+            set = sparseSets.Insert(component, new SparseSet(desc.size, desc.alignment));
+        }
+
+        return *set;
+    }
+
+    ECDB::Archetype* ECDB::FindArchetype(const ArchetypeKey& key) const {
+        auto it = archetypes.find(key);
+        return it != archetypes.end() ? it->second : nullptr;
+    }
+
+    void ECDB::SetSharedComponent(EntityPtr* entity, ComponentId component, const void* value) {
+        // TODO(randomuserhi): Thread Safety
+
+        Deep_Assert(entity->archetype != nullptr, "Entity does not belong to any archetype.");
+
+        ArchetypeDesc description{ entity->archetype->description };
+        description.SetSharedComponent(component, value);
+
+        GetArchetype(description).Move(entity);
+    }
+
+    void ECDB::SetSharedComponent(Archetype& archetype, ComponentId component, const void* value) {
+        // TODO(randomuserhi): Thread Safety
+
+        ArchetypeDesc description{ archetype.description };
+        description.SetSharedComponent(component, value);
+
+        GetArchetype(description).Move(archetype);
+    }
+
+    ECDB::Query& ECDB::GetQuery(const QueryDesc& description) {
+        // TODO(randomuserhi): Thread Safety
+
+        // NOTE(randomuserhi): A linear search is fast enough since the number of queries is often low and queries are
+        //                     typically only obtained once on startup.
+        for (Query* query : queries) {
+            if (query->description == description) {
+                return *query;
+            }
+        }
+
+        Query* query = new Query(this, QueryDesc{ description });
+        queries.push_back(query);
+
+        return *query;
+    }
+
+    ECDB::Prefab& ECDB::CreatePrefab(const ArchetypeDesc& description) {
+        Prefab* prefab = new Prefab(&GetArchetype(description));
+        prefabs.push_back(prefab);
+
+        return *prefab;
+    }
+
+    void ECDB::DispatchParallel(JobSystem* jobSystem, const std::vector<ParallelChunk>& chunks,
+                                const Archetype::ChunkFunction& function, size_t numJobs) {
+        Deep_Assert(jobSystem != nullptr, "JobSystem cannot be a nullptr.");
+        Deep_Assert(numJobs > 0, "Number of jobs must be greater than 0.");
+
+        if (chunks.size() == 0) return;
+
+        numJobs = Deep::Min(numJobs, chunks.size());
+
+        // Evenly distribute chunks across jobs, the first `remainder` jobs take 1 extra chunk
+        const size_t chunksPerJob = chunks.size() / numJobs;
+        const size_t remainder = chunks.size() % numJobs;
 
-                ArchetypeDesc description{ arch->description };
-                description.AddComponent(component);
+        Barrier barrier = jobSystem->AcquireBarrier();
 
-                // Check if we already have the archetype from a different path
-                if (archetypes.find(description.type) != archetypes.end()) {
-                    arch = archetypes[description.type];
-                    continue;
+        size_t begin = 0;
+        for (size_t i = 0; i < numJobs; ++i) {
+            size_t end = begin + chunksPerJob + (i < remainder ? 1 : 0);
+
+            // NOTE(randomuserhi): Capturing by reference is safe as the barrier is waited on prior returning.
+            barrier.AddJob(jobSystem->Enqueue([&chunks, &function, begin, end]() {
+                for (size_t j = begin; j < end; ++j) {
+                    const ParallelChunk& item = chunks[j];
+                    function(item.archetype, item.chunk, item.size, item.offsets);
                 }
+            }));
+
+            begin = end;
+        }
+
+        barrier.Wait();
+    }
+
+    void ECDB::RegisterArchetype(Archetype* archetype) {
+        archetype->id = nextArchetypeId++;
+        archetypes.emplace(archetype->description.GetKey(), archetype);
+
+        // Update cached matches
+        for (Query* query : queries) {
+            query->Register(archetype);
+        }
+    }
 
-                // Create a new archetype
-                Archetype* newArch = new Archetype(this, std::move(description));
-                arch->addMap.emplace(component, newArch);
-                newArch->removeMap.emplace(component, arch);
-                archetypes.emplace(newArch->description.type, newArch);
+    void ECDB::RetireArchetype(Archetype* archetype) {
+        Deep_Assert(archetype != rootArchetype, "The root archetype cannot be retired.");
+        Deep_Assert(archetype->numEntities == 0, "Archetypes with entities cannot be retired.");
 
-                arch = newArch;
+        archetype->ReleaseChunks();
+
+        // Remove edges leading to the archetype
+        //
+        // NOTE(randomuserhi): Edges are created in pairs by `LinkArchetypes`, so only the neighbours of the archetype
+        //                     are visited.
+        auto unlink = [archetype](ComponentMap<Archetype::Edge>& edges, ComponentId component) {
+            const Archetype::Edge* edge = edges.Find(component);
+            if (edge != nullptr && edge->archetype == archetype) edges.Erase(component);
+        };
+        for (const ComponentMap<Archetype::Edge>::Entry& entry : archetype->addMap.entries()) {
+            unlink(entry.value.archetype->removeMap, entry.id);
+        }
+        for (const ComponentMap<Archetype::Edge>::Entry& entry : archetype->removeMap.entries()) {
+            Archetype* other = entry.value.archetype;
+            if (!ECRegistry::IsShared(entry.id)) {
+                unlink(other->addMap, entry.id);
+                continue;
             }
+
+            std::vector<std::pair<Archetype*, ComponentId>>& edges = other->sharedRemoveEdges;
+            edges.erase(std::find(edges.begin(), edges.end(), std::make_pair(archetype, entry.id)));
+        }
+        for (const std::pair<Archetype*, ComponentId>& edge : archetype->sharedRemoveEdges) {
+            unlink(edge.first->removeMap, edge.second);
         }
 
-        return *arch;
+        // Remove from cached matches
+        for (Query* query : queries) {
+            std::vector<Archetype*>& matches = query->matches;
+            auto it = std::find(matches.begin(), matches.end(), archetype);
+            if (it != matches.end()) matches.erase(it);
+        }
+
+        archetypes.erase(archetype->description.GetKey());
+        delete archetype;
     }
 } // namespace Deep
 
 namespace Deep {
     bool operator!=(const ArchetypeBitField& a, const ArchetypeBitField& b) {
+        if (a.hash != b.hash) return true;
+
+#ifdef DEEP_USE_AVX2
+        __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(a.bits));
+        __m256i y = _mm256_load_si256(reinterpret_cast<const __m256i*>(b.bits));
+        __m256i diff = _mm256_xor_si256(x, y);
+        if (!_mm256_testz_si256(diff, diff)) return true;
+#else
+        for (size_t i = 0; i < ArchetypeBitField::inlineSize; ++i) {
+            if (a.bits[i] != b.bits[i]) return true;
+        }
+#endif
+
         size_t i = 0;
-        bool smaller = a.bits.size() <= b.bits.size();
-        const std::vector<ArchetypeBitField::Type>& min = smaller ? a.bits : b.bits;
-        const std::vector<ArchetypeBitField::Type>& max = smaller ? b.bits : a.bits;
+        bool smaller = a.spill.size() <= b.spill.size();
+        const std::vector<ArchetypeBitField::Type>& min = smaller ? a.spill : b.spill;
+        const std::vector<ArchetypeBitField::Type>& max = smaller ? b.spill : a.spill;
         for (; i < min.size(); ++i) {
             if (min[i] != max[i]) return true;
         }
@@ -204,17 +577,79 @@ namespace Deep {
         return !(a != b);
     }
 
+    bool operator==(const ArchetypeKey& a, const ArchetypeKey& b) {
+        return a.type == b.type && a.shared == b.shared;
+    }
+
+    bool ArchetypeBitField::HasAll(const ArchetypeBitField& other) const {
+#ifdef DEEP_USE_AVX2
+        __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(bits));
+        __m256i y = _mm256_load_si256(reinterpret_cast<const __m256i*>(other.bits));
+        if (!_mm256_testc_si256(x, y)) return false;
+#else
+        for (size_t i = 0; i < inlineSize; ++i) {
+            if ((bits[i] & other.bits[i]) != other.bits[i]) return false;
+        }
+#endif
+
+        for (size_t i = 0; i < other.spill.size(); ++i) {
+            Type bit = i < spill.size() ? spill[i] : 0u;
+            if ((bit & other.spill[i]) != other.spill[i]) return false;
+        }
+        return true;
+    }
+
+    bool ArchetypeBitField::HasAny(const ArchetypeBitField& other) const {
+#ifdef DEEP_USE_AVX2
+        __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(bits));
+        __m256i y = _mm256_load_si256(reinterpret_cast<const __m256i*>(other.bits));
+        if (!_mm256_testz_si256(x, y)) return true;
+#else
+        for (size_t i = 0; i < inlineSize; ++i) {
+            if ((bits[i] & other.bits[i]) != 0) return true;
+        }
+#endif
+
+        size_t size = Deep::Min(spill.size(), other.spill.size());
+        for (size_t i = 0; i < size; ++i) {
+            if ((spill[i] & other.spill[i]) != 0) return true;
+        }
+        return false;
+    }
+
+    bool ArchetypeBitField::IsEmpty() const {
+#ifdef DEEP_USE_AVX2
+        __m256i x = _mm256_load_si256(reinterpret_cast<const __m256i*>(bits));
+        if (!_mm256_testz_si256(x, x)) return false;
+#else
+        for (size_t i = 0; i < inlineSize; ++i) {
+            if (bits[i] != 0) return false;
+        }
+#endif
+
+        for (size_t i = 0; i < spill.size(); ++i) {
+            if (spill[i] != 0) return false;
+        }
+        return true;
+    }
+
+    void ArchetypeBitField::SetWord(size_t index, Type word) {
+        Type& target = index < inlineSize ? bits[index] : spill[index - inlineSize];
+        hash ^= HashWord(index, target) ^ HashWord(index, word);
+        target = word;
+    }
+
     ArchetypeBitField& ArchetypeBitField::AddComponent(ComponentId component) {
         Deep_Assert(registry->Has(component), "ComponentId does not exist in registry.");
         Deep_Assert(!HasComponent(component), "Type already contains the given component.");
 
         component = ECRegistry::StripTagBit(component);
 
-        uint32 i = component / ArchetypeBitField::bitsPerType;
-        while (i >= bits.size()) {
-            bits.emplace_back(0u);
+        size_t i = component / bitsPerType;
+        if (i >= inlineSize && i - inlineSize >= spill.size()) {
+            spill.resize(i - inlineSize + 1, 0u);
         }
-        bits[i] |= (1u << (component % ArchetypeBitField::bitsPerType));
+        SetWord(i, *GetWord(component) | (Type(1) << (component % bitsPerType)));
 
         return *this;
     }
@@ -224,9 +659,137 @@ namespace Deep {
 
         component = ECRegistry::StripTagBit(component);
 
-        uint32 i = component / ArchetypeBitField::bitsPerType;
-        if (i < bits.size()) {
-            bits[i] &= ~(1u << (component % ArchetypeBitField::bitsPerType));
+        const Type* word = GetWord(component);
+        if (word != nullptr) {
+            SetWord(component / bitsPerType, *word & ~(Type(1) << (component % bitsPerType)));
+        }
+
+        return *this;
+    }
+} // namespace Deep
+
+namespace Deep {
+    bool operator!=(const ECDB::QueryDesc& a, const ECDB::QueryDesc& b) {
+        return a.with != b.with || a.without != b.without || a.any != b.any || a.changed != b.changed;
+    }
+
+    bool operator==(const ECDB::QueryDesc& a, const ECDB::QueryDesc& b) {
+        return !(a != b);
+    }
+} // namespace Deep
+
+namespace Deep {
+    ECDB::Query::Query(ECDB* database, QueryDesc&& desc) :
+        description(std::move(desc)), database(database) {
+        // Match existing archetypes, new archetypes are registered by the database as they are created
+        for (const auto& kv : database->archetypes) {
+            Register(kv.second);
+        }
+    }
+
+    size_t ECDB::Query::size() const {
+        size_t size = 0;
+        for (const Archetype* archetype : matches) {
+            size += archetype->size();
+        }
+        return size;
+    }
+
+    void ECDB::Query::GatherChunks(std::vector<ParallelChunk>& rwChunks, std::vector<Archetype::ComponentOffset>& rwOffsets,
+                                   const ComponentId* components, size_t numComponents, uint64 sinceVersion,
+                                   const Archetype::ChunkFilter& filter) const {
+#ifdef DEEP_ENABLE_ASSERTS
+        for (size_t i = 0; i < numComponents; ++i) {
+            Deep_Assert(description.with.HasComponent(components[i]), "Component is not part of the query's With set.");
+        }
+#endif
+
+        // Only filter by changes if a version is given
+        const std::vector<ComponentId>& changed = description.changed;
+        size_t numChanged = sinceVersion != 0 ? changed.size() : 0;
+
+        // Resolve component offsets once per archetype
+        // NOTE(randomuserhi): Reserved upfront such that pointers into `rwOffsets` remain valid.
+        rwOffsets.clear();
+        rwOffsets.reserve(matches.size() * (numComponents + numChanged));
+
+        for (const Archetype* archetype : matches) {
+            if (archetype->size() == 0) continue;
+
+            const Archetype::ComponentOffset* archetypeOffsets = rwOffsets.data() + rwOffsets.size();
+            for (size_t i = 0; i < numComponents; ++i) {
+                rwOffsets.push_back(archetype->GetComponentOffset(components[i]));
+            }
+
+            const Archetype::ComponentOffset* changedOffsets = rwOffsets.data() + rwOffsets.size();
+            for (size_t i = 0; i < numChanged; ++i) {
+                rwOffsets.push_back(archetype->GetComponentOffset(changed[i]));
+            }
+
+            archetype->GatherChunks(rwChunks, archetypeOffsets, changedOffsets, numChanged, sinceVersion, filter);
+        }
+    }
+
+    void ECDB::Query::ForEachChunkParallel(JobSystem* jobSystem, const ComponentId* components, size_t numComponents,
+                                           const Archetype::ChunkFunction& function, size_t numJobs,
+                                           uint64 sinceVersion, const Archetype::ChunkFilter& filter) const {
+        std::vector<Archetype::ComponentOffset> offsets;
+        std::vector<ParallelChunk> chunks;
+        GatherChunks(chunks, offsets, components, numComponents, sinceVersion, filter);
+
+        ECDB::DispatchParallel(jobSystem, chunks, function, numJobs);
+    }
+
+    void ECDB::Query::ForEachChunk(const ComponentId* components, size_t numComponents,
+                                   const Archetype::ChunkFunction& function, uint64 sinceVersion,
+                                   const Archetype::ChunkFilter& filter) const {
+        std::vector<Archetype::ComponentOffset> offsets;
+        std::vector<ParallelChunk> chunks;
+        GatherChunks(chunks, offsets, components, numComponents, sinceVersion, filter);
+
+        for (const ParallelChunk& item : chunks) {
+            function(item.archetype, item.chunk, item.size, item.offsets);
+        }
+    }
+} // namespace Deep
+
+namespace Deep {
+    ECDB::Prefab::Prefab(Archetype* archetype) :
+        archetype(archetype) {
+        const std::vector<ComponentDesc>& layout = archetype->description.layout;
+
+        size_t size = 0;
+        for (const ComponentDesc& component : layout) {
+            offsets.push_back(size);
+            size += component.size;
+        }
+        data.resize(size, 0);
+
+        // NOTE(randomuserhi): `data` is never resized after this point, so the pointers remain valid.
+        for (size_t offset : offsets) {
+            prototype.push_back(data.data() + offset);
+        }
+    }
+
+    ECDB::Prefab& ECDB::Prefab::SetComponent(ComponentId component, const void* value) {
+        Deep_Assert(ECRegistry::IsComponent(component), "Only components hold a default value.");
+
+        size_t column = archetype->GetComponentOffset(component).column;
+        Memcpy(data.data() + offsets[column], value, archetype->description.layout[column].size);
+        return *this;
+    }
+} // namespace Deep
+
+namespace Deep {
+    ECDB::QueryDesc& ECDB::QueryDesc::Changed(ComponentId component) & {
+        Deep_Assert(ECRegistry::IsComponent(component), "Tags do not contain data and cannot be changed.");
+
+        auto it = std::lower_bound(changed.begin(), changed.end(), component);
+        Deep_Assert(it == changed.end() || *it != component, "Query already filters by changes to this component.");
+        changed.insert(it, component);
+
+        if (!with.HasComponent(component)) {
+            with.AddComponent(component);
         }
 
         return *this;
@@ -236,11 +799,14 @@ namespace Deep {
 namespace Deep {
     ECDB::ArchetypeDesc& ECDB::ArchetypeDesc::AddComponent(ComponentId component) & {
         Deep_Assert(!HasComponent(component), "Type already contains the given component.");
+        Deep_Assert(!ECRegistry::IsShared(component), "Shared components are added with SetSharedComponent.");
 
         type.AddComponent(component);
 
         if (ECRegistry::IsComponent(component)) {
             layout.push_back(registry->Get(component));
+        } else if (ECRegistry::IsChunk(component)) {
+            chunkLayout.push_back(registry->Get(component));
         }
 
         return *this;
@@ -260,23 +826,111 @@ namespace Deep {
                     break;
                 }
             }
+        } else if (ECRegistry::IsShared(component)) {
+            std::vector<ComponentDesc> shared{ sharedLayout };
+            for (size_t i = 0; i < shared.size(); ++i) {
+                if (shared[i].id == component) {
+                    shared.erase(shared.begin() + i);
+                    break;
+                }
+            }
+            SetSharedLayout(std::move(shared));
+        } else if (ECRegistry::IsChunk(component)) {
+            for (size_t i = 0; i < chunkLayout.size(); ++i) {
+                if (chunkLayout[i].id == component) {
+                    chunkLayout.erase(chunkLayout.begin() + i);
+                    break;
+                }
+            }
+        }
+
+        return *this;
+    }
+
+    ECDB::ArchetypeDesc& ECDB::ArchetypeDesc::SetSharedComponent(ComponentId component, const void* value) & {
+        Deep_Assert(ECRegistry::IsShared(component), "Component is not a shared component.");
+
+        if (!HasComponent(component)) {
+            type.AddComponent(component);
+
+            // Insert in order of ComponentId
+            std::vector<ComponentDesc> shared{ sharedLayout };
+            size_t i = 0;
+            while (i < shared.size() && shared[i].id < component) {
+                ++i;
+            }
+            shared.insert(shared.begin() + i, registry->Get(component));
+            SetSharedLayout(std::move(shared));
+        }
+
+        for (size_t i = 0; i < sharedLayout.size(); ++i) {
+            if (sharedLayout[i].id == component) {
+                Memcpy(sharedData.data() + sharedOffsets[i], value, sharedLayout[i].size);
+                break;
+            }
         }
 
         return *this;
     }
+
+    const void* ECDB::ArchetypeDesc::GetSharedComponent(ComponentId component) const {
+        Deep_Assert(HasComponent(component), "Type does not contain the given shared component.");
+
+        // NOTE(randomuserhi): A linear search is fast enough since the number of shared components is often low.
+        for (size_t i = 0; i < sharedLayout.size(); ++i) {
+            if (sharedLayout[i].id == component) {
+                return sharedData.data() + sharedOffsets[i];
+            }
+        }
+
+        Deep_Unreachable;
+    }
+
+    void ECDB::ArchetypeDesc::SetSharedLayout(std::vector<ComponentDesc>&& layout) {
+        // Compute offsets of each value, aligning each to its alignment
+        std::vector<size_t> offsets(layout.size());
+        size_t size = 0;
+        for (size_t i = 0; i < layout.size(); ++i) {
+            size += (layout[i].alignment - (size % layout[i].alignment)) % layout[i].alignment;
+            offsets[i] = size;
+            size += layout[i].size;
+        }
+
+        // Copy over values of shared components that remain
+        std::vector<uint8> data(size, 0);
+        for (size_t i = 0; i < layout.size(); ++i) {
+            for (size_t j = 0; j < sharedLayout.size(); ++j) {
+                if (sharedLayout[j].id == layout[i].id) {
+                    Memcpy(data.data() + offsets[i], sharedData.data() + sharedOffsets[j], layout[i].size);
+                    break;
+                }
+            }
+        }
+
+        sharedLayout = std::move(layout);
+        sharedOffsets = std::move(offsets);
+        sharedData = std::move(data);
+    }
 } // namespace Deep
 
 namespace Deep {
     ECDB::Archetype::Archetype(ECDB* database, ArchetypeDesc&& desc) :
         database(database),
         description(std::move(desc)),
-        ids(description.layout.size()),
-        offsets(description.layout.size()),
-        chunkSize(database->chunkSize) {
+        chunkSize(database->chunkSize),
+        columns(description.layout.size()) {
 
         Deep_Assert(chunkSize > 0, "chunkSize must be non zero.");
         Deep_Assert(Deep::IsPowerOf2(chunkSize), "chunkSize must be a power of 2.");
 
+        // Chunk components are placed in the chunk header after the change versions
+        allocationSize = chunkSize + sizeof(Chunk*) + sizeof(uint64) + columns.size() * sizeof(uint64);
+        for (const ComponentDesc& comp : description.chunkLayout) {
+            allocationSize += (comp.alignment - (allocationSize % comp.alignment)) % comp.alignment;
+            chunkOffsets.Insert(comp.id, size_t{ allocationSize });
+            allocationSize += comp.size;
+        }
+
         const std::vector<ComponentDesc>& layout = description.layout;
 
         // If layout contains no data, then chunks only contain Metadata and there is nothing to do.
@@ -289,9 +943,11 @@ namespace Deep {
         }
 #endif
 
+        size_t numMasks = 0;
         size_t packedSize = sizeof(Metadata);
         for (size_t i = 0; i < layout.size(); ++i) {
             packedSize += layout[i].size;
+            if (ECRegistry::IsEnableable(layout[i].id)) ++numMasks;
         }
 
         // Binary search to find optimal entitiesPerChunk
@@ -302,10 +958,10 @@ namespace Deep {
         while (lowerBound < upperBound) {
             size_t mid = (lowerBound + upperBound) / 2;
 
-            size_t memSize = mid * sizeof(Metadata);
+            size_t memSize = mid * sizeof(Metadata) + numMasks * ((mid + 63) / 64) * sizeof(uint64);
             for (size_t i = 0; i < layout.size(); ++i) {
                 size_t padding = (DEEP_CACHE_LINE_SIZE - (memSize % DEEP_CACHE_LINE_SIZE)) % DEEP_CACHE_LINE_SIZE;
-                memSize += padding + mid * layout[i].size;
+                memSize += padding + GetColumnSize(layout[i], mid);
             }
 
             if (memSize <= chunkSize) {
@@ -318,8 +974,12 @@ namespace Deep {
 
         Deep_Assert(entitiesPerChunk > 0, "Chunk should be able to fit atleast 1 entity.");
 
+        // Enabled bitmasks are placed right after the Metadata array
+        size_t maskOffset = entitiesPerChunk * sizeof(Metadata);
+        size_t maskSize = ((entitiesPerChunk + 63) / 64) * sizeof(uint64);
+
         // Compute pointer offsets for each component array
-        size_t offset = entitiesPerChunk * sizeof(Metadata);
+        size_t offset = maskOffset + numMasks * maskSize;
         for (size_t i = 0; i < layout.size(); ++i) {
             const ComponentDesc& comp = layout[i];
             Deep_Assert(ECRegistry::IsComponent(comp.id), "Layout should only consist of components, not tags.");
@@ -327,35 +987,24 @@ namespace Deep {
             // Apply padding as necessary
             offset += (DEEP_CACHE_LINE_SIZE - (offset % DEEP_CACHE_LINE_SIZE)) % DEEP_CACHE_LINE_SIZE;
 
+            size_t mask = 0;
+            if (ECRegistry::IsEnableable(comp.id)) {
+                mask = maskOffset;
+                maskOffset += maskSize;
+                masks.push_back(mask);
+            }
+
             // Add component offset entry
-            size_t bucket = comp.id % layout.size();
-            while (ids[bucket] != 0) {
-                ++bucket;
-            };
-            Deep_Assert(comp.id + 1 != 0,
-                        "Storing an id of 0 in the bucket is invalid as 0 represents an empty bucket slot.");
-            ids[bucket] = comp.id + 1;
-            offsets[bucket] = { offset, comp.size };
+            columns[i] = { offset, comp.size, i, mask, comp.fieldSize, comp.lanes };
+            offsets.Insert(comp.id, ComponentOffset{ columns[i] });
 
             // Move to next component array
-            offset += entitiesPerChunk * comp.size;
+            offset += GetColumnSize(comp, entitiesPerChunk);
         }
     }
 
     ECDB::Archetype::~Archetype() {
-        // Delete chunks in use
-        while (tail != nullptr) {
-            Archetype::Chunk* temp = tail;
-            tail = GetNextChunk(tail);
-            AlignedFree(temp);
-        }
-
-        // Delete free list
-        while (firstFree != nullptr) {
-            Archetype::Chunk* temp = firstFree;
-            firstFree = GetNextChunk(firstFree);
-            AlignedFree(temp);
-        }
+        // NOTE(randomuserhi): Chunks are owned by the chunk pools of the database which free them as a whole.
     }
 
     ECDB::Entt ECDB::Archetype::Entity() {
@@ -368,11 +1017,49 @@ namespace Deep {
     }
 
     ECDB::Archetype::ComponentOffset ECDB::Archetype::GetComponentOffset(ComponentId component) const {
-        size_t bucket = component % description.layout.size();
-        while (ids[bucket] != component + 1) {
-            ++bucket;
-        };
-        return offsets[bucket];
+        const ComponentOffset* offset = offsets.Find(component);
+        Deep_Assert(offset != nullptr, "Archetype does not contain the component.");
+        return *offset;
+    }
+
+    void ECDB::Archetype::GatherChunks(std::vector<ParallelChunk>& rwChunks, const ComponentOffset* offsets,
+                                       const ComponentOffset* changed, size_t numChanged, uint64 sinceVersion,
+                                       const ChunkFilter& filter) const {
+        // NOTE(randomuserhi): The list is organised from tail -> head, so only the first chunk is partially filled.
+        size_t size = firstFreeItemInNewChunk;
+        for (Chunk* chunk = tail; chunk != nullptr; chunk = GetNextChunk(chunk)) {
+            bool include = numChanged == 0;
+            for (size_t i = 0; i < numChanged && !include; ++i) {
+                include = GetChangeVersion(chunk, changed[i]) > sinceVersion;
+            }
+            if (include && filter) include = filter(this, chunk);
+
+            if (include) {
+                rwChunks.push_back({ this, chunk, size, offsets });
+            }
+            size = entitiesPerChunk;
+        }
+    }
+
+    void ECDB::Archetype::MarkChunkChanged(Chunk* chunk) const {
+        uint64* versions = GetVersions(chunk);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            versions[i] = database->version;
+        }
+    }
+
+    void ECDB::Archetype::ForEachChunkParallel(JobSystem* jobSystem, const ComponentId* components, size_t numComponents,
+                                               const ChunkFunction& function, size_t numJobs) const {
+        std::vector<ComponentOffset> offsets(numComponents);
+        for (size_t i = 0; i < numComponents; ++i) {
+            Deep_Assert(description.HasComponent(components[i]), "Archetype does not contain the given component.");
+            offsets[i] = GetComponentOffset(components[i]);
+        }
+
+        std::vector<ParallelChunk> chunks;
+        GatherChunks(chunks, offsets.data());
+
+        ECDB::DispatchParallel(jobSystem, chunks, function, numJobs);
     }
 
     void ECDB::Archetype::Deallocate(EntityPtr* entity) {
@@ -386,15 +1073,17 @@ namespace Deep {
         if (tail != entity->chunk || index != entity->index) {
             // Entity from the middle was removed, need to fill slot with last entity
 
-            // Move component data
-            for (size_t i = 0; i < description.layout.size(); ++i) {
-                const ComponentDesc& comp = description.layout[i];
+            Preserve(entity->chunk);
 
-                size_t offset = entity->archetype->GetComponentOffset(comp.id).offset;
+            // Move component data
+            for (const ComponentOffset& column : columns) {
+                CopyComponent(entity->chunk + column.offset, entity->index, column.lanes, tail + column.offset, index,
+                              column.lanes, column.size, column.fieldSize);
+            }
 
-                uint8* src = tail + offset + comp.size * index;
-                uint8* dest = entity->chunk + offset + comp.size * entity->index;
-                Memcpy(dest, src, comp.size);
+            // Move enabled bits
+            for (size_t mask : masks) {
+                SetEnabledBit(entity->chunk, mask, entity->index, GetEnabledBit(tail, mask, index));
             }
 
             // Move entity pointer
@@ -402,9 +1091,15 @@ namespace Deep {
             EntityPtr* entt = metadata.entt;
             entt->chunk = entity->chunk;
             entt->index = entity->index;
+
+            // Move metadata
+            reinterpret_cast<Metadata*>(entity->chunk)[entity->index].entt = entt;
+
+            MarkChunkChanged(entity->chunk);
         } else {
             // Last entity was removed, don't need to fill the slot
 #ifdef DEEP_ENABLE_ASSERTS
+            Preserve(tail);
             Metadata& metadata = reinterpret_cast<Metadata*>(tail)[index];
             metadata.entt = nullptr;
 #endif
@@ -412,13 +1107,10 @@ namespace Deep {
 
         // Remove last entity from chunk (it has been moved to fill a slot)
         if (--firstFreeItemInNewChunk == 0) {
-            // Final chunk no longer has any entities, release it to free list
+            // Final chunk no longer has any entities, release it to the chunk pool
 
             Chunk* temp = GetNextChunk(tail);
-
-            SetNextChunk(tail, firstFree);
-            firstFree = tail;
-
+            FreeChunk(tail);
             tail = temp;
 
             firstFreeItemInNewChunk = entitiesPerChunk;
@@ -434,84 +1126,358 @@ namespace Deep {
 #endif
     }
 
-    void ECDB::Archetype::Move(EntityPtr* entity) {
+    void ECDB::Archetype::Swap(EntityPtr* a, EntityPtr* b) {
         // TODO(randomuserhi): Thread safety
 
-        // Obtain chunk to place entity in
-        Chunk* chunk;
+        Deep_Assert(a->archetype == this && b->archetype == this, "Entities do not belong to this archetype.");
+
+        if (a == b) return;
+
+        Preserve(a->chunk);
+        Preserve(b->chunk);
+
+        // Swap component data
+        for (const ComponentOffset& column : columns) {
+            SwapComponent(a->chunk + column.offset, a->index, b->chunk + column.offset, b->index, column.lanes,
+                          column.size, column.fieldSize);
+        }
+
+        // Swap enabled bits
+        for (size_t mask : masks) {
+            bool enabled = GetEnabledBit(a->chunk, mask, a->index);
+            SetEnabledBit(a->chunk, mask, a->index, GetEnabledBit(b->chunk, mask, b->index));
+            SetEnabledBit(b->chunk, mask, b->index, enabled);
+        }
+
+        // Swap metadata
+        reinterpret_cast<Metadata*>(a->chunk)[a->index].entt = b;
+        reinterpret_cast<Metadata*>(b->chunk)[b->index].entt = a;
+
+        // Swap entity pointers
+        std::swap(a->chunk, b->chunk);
+        std::swap(a->index, b->index);
+
+        MarkChunkChanged(a->chunk);
+        MarkChunkChanged(b->chunk);
+    }
+
+    void ECDB::Archetype::ReleaseChunks() {
+        // TODO(randomuserhi): Thread safety
+
+        while (tail != nullptr) {
+            Chunk* temp = GetNextChunk(tail);
+            FreeChunk(tail);
+            tail = temp;
+        }
+
+        firstFreeItemInNewChunk = 0;
+        numEntities = 0;
+    }
+
+    ECDB::Archetype::Chunk* ECDB::Archetype::AllocateChunk() {
+        if (allocator == nullptr) {
+            allocator = database->GetChunkAllocator(allocationSize);
+        }
+
+        Chunk* chunk = reinterpret_cast<Chunk*>(allocator->Allocate());
+        Deep_Assert(chunk != nullptr, "Allocated chunk should not be a nullptr.");
+
+        // Zero initialize chunk components
+        size_t chunkComponents = GetChunkComponentsOffset();
+        std::memset(chunk + chunkComponents, 0, allocationSize - chunkComponents);
+
+        // NOTE(randomuserhi): Pooled chunks were preserved for forks when they were freed.
+        GetEpoch(chunk).store(database->forkEpoch, std::memory_order_relaxed);
+
+        MarkChunkChanged(chunk);
+
+        // Append chunk to list
+        SetNextChunk(chunk, tail);
+        tail = chunk;
 
-        if (tail != nullptr) {
-            // Chunks are available in chunk list
+        firstFreeItemInNewChunk = 0;
 
-            if (firstFreeItemInNewChunk < entitiesPerChunk) {
-                // Fit entity at the tail end of chunk list
+        return chunk;
+    }
+
+    void ECDB::Archetype::FreeChunk(Chunk* chunk) {
+        // NOTE(randomuserhi): The chunk may still be shared with forks, its contents need to be preserved before it is
+        //                     reused by any archetype.
+        Preserve(chunk);
+
+        allocator->Free(chunk);
+    }
+
+    std::vector<ECDB::Entt> ECDB::Archetype::CreateEntities(size_t count, const ColumnFunction& init) {
+        std::vector<EntityPtr*> entities(count);
+        database->AllocateEntities(entities.data(), count);
+
+        Emplace(entities.data(), count, init);
+
+        std::vector<ECDB::Entt> handles;
+        handles.reserve(count);
+        for (EntityPtr* entity : entities) {
+            handles.emplace_back(database, entity);
+        }
+        return handles;
+    }
+
+    std::vector<ECDB::Entt> ECDB::Archetype::CreateEntities(size_t count, const void* const* prototype) {
+        return CreateEntities(count, [this, prototype](size_t column, void* data, size_t numItems) {
+            if (prototype[column] == nullptr) return;
+            MemcpyFill(data, prototype[column], description.layout[column].size, numItems);
+        });
+    }
+
+    void ECDB::Archetype::Emplace(EntityPtr* const* entities, size_t count, const ColumnFunction& init) {
+        // TODO(randomuserhi): Thread safety
+
+        std::vector<uint8> scratch;
 
+        size_t i = 0;
+        while (i < count) {
+            // Obtain chunk to place entities in
+            Chunk* chunk;
+            if (tail != nullptr && firstFreeItemInNewChunk < entitiesPerChunk) {
                 chunk = tail;
             } else {
-                // Tail chunk is full, need a new chunk
+                chunk = AllocateChunk();
+            }
+
+            Preserve(chunk);
+
+            // Fill as much of the chunk as possible
+            size_t first = firstFreeItemInNewChunk;
+            size_t numItems = Deep::Min(count - i, entitiesPerChunk - first);
+
+            Metadata* metadata = reinterpret_cast<Metadata*>(chunk) + first;
+            for (size_t j = 0; j < numItems; ++j) {
+                EntityPtr* entity = entities[i + j];
+                Deep_Assert(entity->archetype == nullptr, "Entity already belongs to an archetype.");
+
+                metadata[j].entt = entity;
+
+                entity->archetype = this;
+                entity->chunk = chunk;
+                entity->index = first + j;
+            }
+
+            // Created entities have all components enabled
+            for (size_t mask : masks) {
+                for (size_t j = 0; j < numItems; ++j) {
+                    SetEnabledBit(chunk, mask, first + j, true);
+                }
+            }
+
+            if (init) {
+                for (size_t column = 0; column < columns.size(); ++column) {
+                    const ComponentOffset& offset = columns[column];
+                    if (offset.lanes == 0) {
+                        init(column, chunk + offset.offset + offset.size * first, numItems);
+                        continue;
+                    }
+
+                    // Laned components are initialized as an array of whole components and then split into lanes
+                    scratch.resize(numItems * offset.size);
+                    init(column, scratch.data(), numItems);
+                    for (size_t j = 0; j < numItems; ++j) {
+                        CopyComponent(chunk + offset.offset, first + j, offset.lanes, scratch.data(), j, 0, offset.size,
+                                      offset.fieldSize);
+                    }
+                }
+            }
 
-                if (firstFree != nullptr) {
-                    // Take chunk from free list
+            MarkChunkChanged(chunk);
 
-                    chunk = firstFree;
-                    firstFree = GetNextChunk(firstFree);
-                } else {
-                    // Free list is empty, allocate a new chunk
+            firstFreeItemInNewChunk += numItems;
+            numEntities += numItems;
+            i += numItems;
+        }
+    }
+
+    bool ECDB::Archetype::SharesLayout(const Archetype& other) const {
+        if (chunkSize != other.chunkSize || entitiesPerChunk != other.entitiesPerChunk) return false;
+        if (columns.size() != other.columns.size()) return false;
+
+        // Chunk components travel with the chunk, so both archetypes must have the same chunk components
+        if (allocationSize != other.allocationSize || chunkOffsets.size() != other.chunkOffsets.size()) return false;
+        for (const ComponentMap<size_t>::Entry& entry : chunkOffsets.entries()) {
+            const size_t* b = other.chunkOffsets.Find(entry.id);
+            if (b == nullptr || *b != entry.value) return false;
+        }
+
+        for (const ComponentMap<ComponentOffset>::Entry& entry : offsets.entries()) {
+            const ComponentOffset* b = other.offsets.Find(entry.id);
+            if (b == nullptr) return false;
+
+            const ComponentOffset& a = entry.value;
+            if (a.offset != b->offset || a.size != b->size || a.column != b->column || a.mask != b->mask) return false;
+        }
+        return true;
+    }
+
+    void ECDB::Archetype::Move(Archetype& source) {
+        // TODO(randomuserhi): Thread safety
+
+        if (&source == this) return;
+
+        if (SharesLayout(source)) {
+            TradeChunks(source);
+            return;
+        }
 
-                    chunk = reinterpret_cast<Chunk*>(AlignedMalloc(chunkSize + sizeof(Chunk*), DEEP_CACHE_LINE_SIZE));
-                    SetNextChunk(chunk, nullptr);
+        // Move entities from the back of the tail chunk such that no entity needs to be swapped to fill the gap
+        TransitionPlan plan = GetTransitionPlan(source);
+        while (source.numEntities > 0) {
+            Move(GetMetaList(source.tail)[source.firstFreeItemInNewChunk - 1].entt, plan);
+        }
+    }
+
+    void ECDB::Archetype::TradeChunks(Archetype& source) {
+        // TODO(randomuserhi): Thread safety
+
+        Deep_Assert(&source != this, "Cannot trade chunks with itself.");
+        Deep_Assert(SharesLayout(source), "Archetypes must share the same layout to trade chunks.");
+
+        if (source.numEntities == 0) return;
+
+        // The partially filled tail chunk of source (if any)
+        Chunk* partial = source.firstFreeItemInNewChunk < entitiesPerChunk ? source.tail : nullptr;
+        size_t partialSize = source.firstFreeItemInNewChunk;
+
+        // If our tail is full (or we have no chunks), source's tail can become our tail as is
+        bool canTakeTail = tail == nullptr || firstFreeItemInNewChunk == entitiesPerChunk;
+        if (canTakeTail) partial = nullptr;
+
+        // Chunks that are relinked into this archetype
+        Chunk* first = partial != nullptr ? GetNextChunk(partial) : source.tail;
+
+        if (first != nullptr) {
+            // Update the archetype of all entities in the traded chunks and find the end of the list
+            Chunk* last = first;
+            size_t size = partial != nullptr ? entitiesPerChunk : partialSize;
+            for (Chunk* chunk = first; chunk != nullptr; chunk = GetNextChunk(chunk)) {
+                const Metadata* metadata = GetMetaList(chunk);
+                for (size_t i = 0; i < size; ++i) {
+                    database->RecordMove(metadata[i].entt, &source, this);
+                    metadata[i].entt->archetype = this;
                 }
+                MarkChunkChanged(chunk);
+
+                numEntities += size;
+                source.numEntities -= size;
+
+                last = chunk;
+                size = entitiesPerChunk;
+            }
+
+            if (canTakeTail) {
+                // Source's list (with its tail) goes in front of our list
+                SetNextChunk(last, tail);
+                tail = first;
+                firstFreeItemInNewChunk = partialSize;
+            } else {
+                // Full chunks are inserted right after our partially filled tail
+                SetNextChunk(last, GetNextChunk(tail));
+                SetNextChunk(tail, first);
+            }
+        }
 
-                firstFreeItemInNewChunk = 0;
+        if (partial != nullptr) {
+            // Only the partially filled chunk remains in source, move its entities individually
+            source.tail = partial;
+            SetNextChunk(partial, nullptr);
 
-                // Append chunk to list
-                SetNextChunk(chunk, tail);
-                tail = chunk;
+            TransitionPlan plan = GetTransitionPlan(source);
+            while (source.numEntities > 0) {
+                Move(GetMetaList(partial)[source.firstFreeItemInNewChunk - 1].entt, plan);
             }
         } else {
-            // Chunk list is empty
+            source.tail = nullptr;
+            source.firstFreeItemInNewChunk = 0;
+        }
 
-            if (firstFree != nullptr) {
-                // Take chunk from free list
+        Deep_Assert(source.numEntities == 0, "All entities should have been moved.");
+    }
 
-                chunk = firstFree;
-                firstFree = GetNextChunk(firstFree);
-            } else {
-                // Free list is empty, allocate a new chunk
+    ECDB::Archetype::TransitionPlan ECDB::Archetype::GetTransitionPlan(const Archetype& source) const {
+        TransitionPlan plan;
+
+        const std::vector<ComponentDesc>& layout = source.description.layout;
+        for (size_t i = 0; i < layout.size(); ++i) {
+            const ComponentDesc& comp = layout[i];
 
-                chunk = reinterpret_cast<Chunk*>(AlignedMalloc(chunkSize + sizeof(Chunk*), DEEP_CACHE_LINE_SIZE));
-                SetNextChunk(chunk, nullptr);
+            if (description.HasComponent(comp.id)) {
+                const ComponentOffset& src = source.columns[i];
+                ComponentOffset dst = GetComponentOffset(comp.id);
+                plan.push_back({ src.offset, dst.offset, comp.size, src.mask, dst.mask, comp.fieldSize, comp.lanes });
             }
+        }
+
+        return plan;
+    }
+
+    void ECDB::Archetype::Move(EntityPtr* entity) {
+        if (entity->archetype == nullptr || entity->archetype == this) {
+            // No component data to copy
+            Move(entity, TransitionPlan{});
+        } else {
+            Move(entity, GetTransitionPlan(*entity->archetype));
+        }
+    }
 
-            firstFreeItemInNewChunk = 0;
+    void ECDB::Archetype::Move(EntityPtr* entity, const TransitionPlan& plan) {
+        // TODO(randomuserhi): Thread safety
 
-            tail = chunk;
+        // Entity is already in this archetype
+        if (entity->archetype == this) return;
+
+        Deep_Assert(entity->archetype != nullptr || plan.empty(),
+                    "An entity that does not belong to an archetype has no component data to copy.");
+
+        // Obtain chunk to place entity in
+        Chunk* chunk;
+        if (tail != nullptr && firstFreeItemInNewChunk < entitiesPerChunk) {
+            // Fit entity at the tail end of chunk list
+            chunk = tail;
+        } else {
+            // Tail chunk is full (or there are no chunks), need a new chunk
+            chunk = AllocateChunk();
         }
 
         Deep_Assert(chunk != nullptr, "Allocated chunk should not be a nullptr.");
 
+        Preserve(chunk);
+
         // Assign metadata
         Metadata* metadata = reinterpret_cast<Metadata*>(chunk);
         metadata[firstFreeItemInNewChunk].entt = entity;
 
+        // Components are enabled by default, enabled bits are carried over from the old archetype below
+        for (size_t mask : masks) {
+            SetEnabledBit(chunk, mask, firstFreeItemInNewChunk, true);
+        }
+
         if (entity->archetype != nullptr) {
-            // Copy data to this archetype from old archetype component by component.
+            database->RecordMove(entity, entity->archetype, this);
+
+            // Copy data to this archetype from old archetype column by column.
 
-            const ArchetypeDesc& description = entity->archetype->description;
-            for (size_t i = 0; i < description.layout.size(); ++i) {
-                const ComponentDesc& comp = description.layout[i];
+            for (const ColumnCopy& copy : plan) {
+                CopyComponent(chunk + copy.dstOffset, firstFreeItemInNewChunk, copy.lanes,
+                              entity->chunk + copy.srcOffset, entity->index, copy.lanes, copy.size, copy.fieldSize);
 
-                if (this->description.HasComponent(comp.id)) {
-                    uint8* src =
-                        entity->chunk + entity->archetype->GetComponentOffset(comp.id).offset + comp.size * entity->index;
-                    uint8* dest = chunk + GetComponentOffset(comp.id).offset + comp.size * firstFreeItemInNewChunk;
-                    Memcpy(dest, src, comp.size);
+                if (copy.dstMask != 0) {
+                    SetEnabledBit(chunk, copy.dstMask, firstFreeItemInNewChunk,
+                                  GetEnabledBit(entity->chunk, copy.srcMask, entity->index));
                 }
             }
 
             entity->archetype->Deallocate(entity);
         }
 
+        MarkChunkChanged(chunk);
+
         // Update entity ptr
         entity->archetype = this;
         entity->chunk = chunk;
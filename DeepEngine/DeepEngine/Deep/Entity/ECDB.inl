@@ -1,5 +1,32 @@
 #pragma once
 
+namespace Deep {
+    EntityHandle::EntityHandle(uint32 index, uint32 generation) :
+        value((static_cast<Type>(generation) & generationMask) << indexBits | (static_cast<Type>(index) & indexMask)) {
+        Deep_Assert(index < maxIndex, "Index exceeds the maximum number of entities.");
+    }
+
+    uint32 EntityHandle::GetIndex() const {
+        return static_cast<uint32>(value & indexMask);
+    }
+
+    uint32 EntityHandle::GetGeneration() const {
+        return static_cast<uint32>((value >> indexBits) & generationMask);
+    }
+
+    bool EntityHandle::IsNull() const {
+        return value == ~Type(0);
+    }
+
+    bool operator==(EntityHandle a, EntityHandle b) {
+        return a.value == b.value;
+    }
+
+    bool operator!=(EntityHandle a, EntityHandle b) {
+        return a.value != b.value;
+    }
+} // namespace Deep
+
 namespace Deep {
     ECDB::Entt::Entt(ECDB* database, EntityPtr* ptr) :
         ptr(ptr), database(database) {};
@@ -8,6 +35,10 @@ namespace Deep {
         return ptr;
     }
 
+    EntityHandle ECDB::Entt::GetHandle() const {
+        return database->GetHandle(ptr);
+    }
+
     ECDB::Entt& ECDB::Entt::AddComponent(ComponentId component) {
         database->AddComponent(ptr, component);
         return *this;
@@ -17,13 +48,181 @@ namespace Deep {
         database->RemoveComponent(ptr, component);
         return *this;
     }
+
+    ECDB::Entt& ECDB::Entt::SetSharedComponent(ComponentId component, const void* value) {
+        database->SetSharedComponent(ptr, component, value);
+        return *this;
+    }
+
+    template<typename T>
+    ECDB::Entt& ECDB::Entt::SetSharedComponent(ComponentId component, const T& value) {
+        database->SetSharedComponent(ptr, component, value);
+        return *this;
+    }
+
+    ECDB::Entt& ECDB::Entt::SetEnabled(ComponentId component, bool enabled) {
+        database->SetEnabled(ptr, component, enabled);
+        return *this;
+    }
+
+    bool ECDB::Entt::IsEnabled(ComponentId component) const {
+        return database->IsEnabled(ptr, component);
+    }
+
+    void ECDB::Entt::Destroy() {
+        database->Destroy(ptr);
+    }
+} // namespace Deep
+
+namespace Deep {
+    ECDB::CommandBuffer::DeferredEntt::DeferredEntt(EntityPtr* entity) :
+        entity(entity), index(0) {}
+
+    ECDB::CommandBuffer::DeferredEntt::DeferredEntt(const ECDB::Entt& entity) :
+        entity(entity), index(0) {}
+
+    ECDB::CommandBuffer::DeferredEntt::DeferredEntt(size_t index) :
+        entity(nullptr), index(index) {}
+
+    ECDB::CommandBuffer::CommandBuffer(ECDB* database) :
+        database(database) {
+        // TODO(randomuserhi): Thread Safety
+        database->commandBuffers.push_back(this);
+    }
+
+    template<typename T>
+    void ECDB::CommandBuffer::SetComponent(DeferredEntt entity, ComponentId component, const T& value) {
+        Deep_Assert(sizeof(T) == database->registry->Get(component).size, "Size of type does not match the component.");
+        SetComponent(entity, component, static_cast<const void*>(&value));
+    }
+
+    bool ECDB::CommandBuffer::IsEmpty() const {
+        return commands.size() == 0;
+    }
+
+    void ECDB::CommandBuffer::Clear() {
+        commands.clear();
+        data.clear();
+        numCreated = 0;
+    }
+
+    ECDB::ForkState::ForkState(ECDB* database) :
+        database(database) {}
+
+    void ECDB::ForkState::ChunkCopy::Acquire() {
+        ++referenceCount;
+    }
+
+    void ECDB::ForkState::ChunkCopy::Release() {
+        if (--referenceCount == 0) {
+            delete this;
+        }
+    }
+
+    void ECDB::Playback(CommandBuffer& buffer) {
+        CommandBuffer* buffers[1] = { &buffer };
+        Playback(buffers, 1);
+    }
 } // namespace Deep
 
 namespace Deep {
-    ECDB::ECDB(ECRegistry* registry, size_t chunkSize) :
-        registry(registry), chunkSize(chunkSize) {
+    ECDB::ECDB(ECRegistry* registry, size_t chunkSize, bool useHugePages) :
+        registry(registry), chunkSize(chunkSize), useHugePages(useHugePages) {
         rootArchetype = new Archetype(this);
-        archetypes.emplace(rootArchetype->description.type, rootArchetype);
+        RegisterArchetype(rootArchetype);
+    }
+
+    template<typename T>
+    void ECDB::SetSharedComponent(EntityPtr* entity, ComponentId component, const T& value) {
+        Deep_Assert(registry->Get(component).size == sizeof(T), "Size of type does not match the component.");
+        SetSharedComponent(entity, component, static_cast<const void*>(&value));
+    }
+
+    void ECDB::SetEnabled(EntityPtr* entity, ComponentId component, bool enabled) {
+        Deep_Assert(entity->archetype != nullptr, "Entity does not belong to any archetype.");
+        entity->archetype->SetEnabled(entity, component, enabled);
+    }
+
+    bool ECDB::IsEnabled(EntityPtr* entity, ComponentId component) const {
+        Deep_Assert(entity->archetype != nullptr, "Entity does not belong to any archetype.");
+        return entity->archetype->IsEnabled(entity, component);
+    }
+
+    uint64 ECDB::GetVersion() const {
+        return version;
+    }
+
+    uint64 ECDB::Tick() {
+        return ++version;
+    }
+
+    void ECDB::SetEventRecording(bool enabled) {
+        recordEvents = enabled;
+    }
+
+    const std::vector<EntityHandle>& ECDB::GetCreatedEvents() const {
+        return createdEvents;
+    }
+
+    const std::vector<EntityHandle>& ECDB::GetDestroyedEvents() const {
+        return destroyedEvents;
+    }
+
+    const std::vector<ECDB::MoveEvent>& ECDB::GetMovedEvents() const {
+        return movedEvents;
+    }
+
+    void ECDB::ClearEvents() {
+        createdEvents.clear();
+        destroyedEvents.clear();
+        movedEvents.clear();
+    }
+
+    void ECDB::RecordMove(EntityPtr* entity, const Archetype* from, const Archetype* to) {
+        if (recordEvents) movedEvents.push_back({ GetHandle(entity), from, to });
+    }
+
+    EntityHandle ECDB::GetHandle(EntityPtr* entity) const {
+        const EntitySlot* slot = GetEntitySlot(entity);
+        return EntityHandle{ slot->index, slot->generation };
+    }
+
+    bool ECDB::IsValid(EntityHandle handle) const {
+        if (handle.IsNull() || handle.GetIndex() >= numEntitySlots) return false;
+
+        const EntitySlot& slot = GetEntitySlot(handle.GetIndex());
+        return slot.nextFree == usedSlot && slot.generation == handle.GetGeneration();
+    }
+
+    ECDB::Entt ECDB::GetEntity(EntityHandle handle) {
+        Deep_Assert(IsValid(handle), "Handle does not refer to an existing entity.");
+        return Entt{ this, &GetEntitySlot(handle.GetIndex()).ptr };
+    }
+
+    ECDB::EntitySlot& ECDB::GetEntitySlot(uint32 index) const {
+        return entityBlocks[index / entityBlockSize][index % entityBlockSize];
+    }
+
+    ECDB::EntitySlot* ECDB::GetEntitySlot(EntityPtr* entity) {
+        return reinterpret_cast<EntitySlot*>(entity);
+    }
+
+    SparseSet* ECDB::FindSparseSet(ComponentId component) const {
+        SparseSet* const* set = sparseSets.Find(component);
+        return set != nullptr ? *set : nullptr;
+    }
+
+    void* ECDB::GetSparseComponent(EntityPtr* entity, ComponentId component) const {
+        Deep_Assert(ECRegistry::IsSparse(component), "Component is not a sparse component.");
+
+        const SparseSet* set = FindSparseSet(component);
+        return set != nullptr ? set->Find(GetEntitySlot(entity)->index) : nullptr;
+    }
+
+    template<typename T>
+    T* ECDB::GetSparseComponent(EntityPtr* entity, ComponentId component) const {
+        Deep_Assert(sizeof(T) == registry->Get(component).size, "Type does not match the size of the component.");
+        return reinterpret_cast<T*>(GetSparseComponent(entity, component));
     }
 } // namespace Deep
 
@@ -34,13 +233,20 @@ namespace Deep {
     bool ArchetypeBitField::HasComponent(ComponentId component) const {
         component = ECRegistry::StripTagBit(component);
 
-        uint32 i = component / ArchetypeBitField::bitsPerType;
+        const Type* word = GetWord(component);
+        return word != nullptr && (*word & (Type(1) << (component % bitsPerType))) != 0u;
+    }
 
-        if (i < bits.size()) {
-            return (bits[i] & (1u << (component % ArchetypeBitField::bitsPerType))) != 0u;
-        }
+    const ArchetypeBitField::Type* ArchetypeBitField::GetWord(ComponentId component) const {
+        size_t i = component / bitsPerType;
+        if (i < inlineSize) return &bits[i];
 
-        return false;
+        i -= inlineSize;
+        return i < spill.size() ? &spill[i] : nullptr;
+    }
+
+    size_t ArchetypeBitField::HashWord(size_t index, Type word) {
+        return word != 0 ? std::hash<Type>()(word) ^ (index * 0xabefcedf) : 0;
     }
 } // namespace Deep
 
@@ -59,6 +265,230 @@ namespace Deep {
     ECDB::ArchetypeDesc&& ECDB::ArchetypeDesc::RemoveComponent(ComponentId component) && {
         return std::move(RemoveComponent(component));
     };
+
+    ECDB::ArchetypeDesc&& ECDB::ArchetypeDesc::SetSharedComponent(ComponentId component, const void* value) && {
+        return std::move(SetSharedComponent(component, value));
+    };
+
+    ArchetypeKey ECDB::ArchetypeDesc::GetKey() const {
+        return ArchetypeKey{ type, sharedData };
+    }
+} // namespace Deep
+
+namespace Deep {
+    ECDB::QueryDesc::QueryDesc(ECRegistry* registry) :
+        registry(registry), with(registry), without(registry), any(registry) {}
+
+    ECDB::QueryDesc& ECDB::QueryDesc::With(ComponentId component) & {
+        Deep_Assert(!ECRegistry::IsSparse(component), "Sparse components are not part of archetypes, use Query::Join.");
+        with.AddComponent(component);
+        return *this;
+    }
+
+    ECDB::QueryDesc&& ECDB::QueryDesc::With(ComponentId component) && {
+        return std::move(With(component));
+    }
+
+    ECDB::QueryDesc& ECDB::QueryDesc::Without(ComponentId component) & {
+        Deep_Assert(!ECRegistry::IsSparse(component), "Sparse components are not part of archetypes, use Query::Join.");
+        without.AddComponent(component);
+        return *this;
+    }
+
+    ECDB::QueryDesc&& ECDB::QueryDesc::Without(ComponentId component) && {
+        return std::move(Without(component));
+    }
+
+    ECDB::QueryDesc& ECDB::QueryDesc::Any(ComponentId component) & {
+        Deep_Assert(!ECRegistry::IsSparse(component), "Sparse components are not part of archetypes, use Query::Join.");
+        any.AddComponent(component);
+        return *this;
+    }
+
+    ECDB::QueryDesc&& ECDB::QueryDesc::Any(ComponentId component) && {
+        return std::move(Any(component));
+    }
+
+    ECDB::QueryDesc&& ECDB::QueryDesc::Changed(ComponentId component) && {
+        return std::move(Changed(component));
+    }
+
+    bool ECDB::QueryDesc::Matches(const ArchetypeBitField& type) const {
+        return type.HasAll(with) && !type.HasAny(without) && (any.IsEmpty() || type.HasAny(any));
+    }
+} // namespace Deep
+
+namespace Deep {
+    template<typename Field, size_t Lanes>
+    ECDB::LaneColumn<Field, Lanes>::LaneColumn(uint8* data, size_t numFields, size_t size) :
+        data(data), numFields(numFields), size(size) {}
+
+    template<typename Field, size_t Lanes>
+    size_t ECDB::LaneColumn<Field, Lanes>::NumBlocks() const {
+        return (size + Lanes - 1) / Lanes;
+    }
+
+    template<typename Field, size_t Lanes>
+    Field* ECDB::LaneColumn<Field, Lanes>::GetLane(size_t block, size_t field) const {
+        Deep_Assert(field < numFields, "Field does not exist.");
+        return reinterpret_cast<Field*>(data) + (block * numFields + field) * Lanes;
+    }
+
+    template<typename Field, size_t Lanes>
+    Field& ECDB::LaneColumn<Field, Lanes>::Get(size_t index, size_t field) const {
+        Deep_Assert(index < size, "Index is out of bounds.");
+        return GetLane(index / Lanes, field)[index % Lanes];
+    }
+
+#ifdef DEEP_USE_AVX2
+    template<typename Field, size_t Lanes>
+    __m256 ECDB::LaneColumn<Field, Lanes>::Load(size_t block, size_t field) const {
+        static_assert(std::is_same<typename std::remove_const<Field>::type, float>::value && Lanes == 8,
+                      "Load is only available for 8 lanes of float.");
+        return _mm256_load_ps(GetLane(block, field));
+    }
+
+    template<typename Field, size_t Lanes>
+    void ECDB::LaneColumn<Field, Lanes>::Store(size_t block, size_t field, __m256 value) const {
+        static_assert(std::is_same<Field, float>::value && Lanes == 8, "Store is only available for 8 lanes of float.");
+        _mm256_store_ps(GetLane(block, field), value);
+    }
+#endif
+} // namespace Deep
+
+namespace Deep {
+    template<typename T, typename Function>
+    void ECDB::Query::Join(ComponentId component, Function&& function) const {
+        Deep_Assert(ECRegistry::IsSparse(component), "Component is not a sparse component.");
+
+        const SparseSet* set = database->FindSparseSet(component);
+        if (set == nullptr) return;
+
+        for (size_t i = 0; i < set->size(); ++i) {
+            EntityPtr* entity = &database->GetEntitySlot(set->GetKey(i)).ptr;
+
+            Archetype* archetype = entity->archetype;
+            if (archetype == nullptr || !description.Matches(archetype->description.type)) continue;
+
+            function(*archetype, Entt{ database, entity }, *reinterpret_cast<T*>(set->GetValue(i)));
+        }
+    }
+} // namespace Deep
+
+namespace Deep {
+    template<typename... Ts>
+    ECDB::View<Ts...>::View(const Query& query, const std::array<ComponentId, sizeof...(Ts)>& components) :
+        query(query), components(components) {
+#ifdef DEEP_ENABLE_ASSERTS
+        for (ComponentId component : components) {
+            Deep_Assert(query.description.with.HasComponent(component),
+                        "Component is not part of the query's With set.");
+        }
+#endif
+    }
+
+    template<typename... Ts>
+    template<typename Function>
+    void ECDB::View<Ts...>::ForEachChunk(Function&& function, uint64 sinceVersion,
+                                         const Archetype::ChunkFilter& filter) const {
+        ForEachChunk(std::forward<Function>(function), sinceVersion, filter, std::index_sequence_for<Ts...>{});
+    }
+
+    template<typename... Ts>
+    template<typename Function>
+    void ECDB::View<Ts...>::ForEach(Function&& function, uint64 sinceVersion,
+                                    const Archetype::ChunkFilter& filter) const {
+        ForEachChunk(
+            [&function](size_t count, Ts* Deep_Restrict... columns) {
+                for (size_t i = 0; i < count; ++i) {
+                    function(columns[i]...);
+                }
+            },
+            sinceVersion, filter);
+    }
+
+    template<typename... Ts>
+    template<typename Function, size_t... Is>
+    void ECDB::View<Ts...>::ForEachChunk(Function&& function, uint64 sinceVersion,
+                                         const Archetype::ChunkFilter& filter, std::index_sequence<Is...>) const {
+        // Only filter by changes if a version is given
+        const std::vector<ComponentId>& changed = query.description.changed;
+        size_t numChanged = sinceVersion != 0 ? changed.size() : 0;
+        std::vector<Archetype::ComponentOffset> changedOffsets(numChanged);
+
+        for (const Archetype* archetype : query.matches) {
+            if (archetype->numEntities == 0) continue;
+
+            // Resolve component offsets once per archetype
+            const std::array<Archetype::ComponentOffset, sizeof...(Ts)> offsets = {
+                archetype->GetComponentOffset(components[Is])...
+            };
+            for (const Archetype::ComponentOffset& offset : offsets) {
+                Deep_Assert(offset.lanes == 0, "Laned components are unsupported, use GetLaneColumn.");
+            }
+            for (size_t i = 0; i < numChanged; ++i) {
+                changedOffsets[i] = archetype->GetComponentOffset(changed[i]);
+            }
+
+            // NOTE(randomuserhi): The list is organised from tail -> head, so only the first chunk is partially filled.
+            size_t size = archetype->firstFreeItemInNewChunk;
+            for (Archetype::Chunk* chunk = archetype->tail; chunk != nullptr; chunk = archetype->GetNextChunk(chunk)) {
+                bool include = numChanged == 0;
+                for (size_t i = 0; i < numChanged && !include; ++i) {
+                    include = archetype->GetChangeVersion(chunk, changedOffsets[i]) > sinceVersion;
+                }
+                if (include && filter) include = filter(archetype, chunk);
+
+                if (include) {
+                    function(size, archetype->template GetCompList<Ts>(chunk, offsets[Is])...);
+                }
+                size = archetype->entitiesPerChunk;
+            }
+        }
+    }
+} // namespace Deep
+
+namespace Deep {
+    const std::vector<ECDB::Archetype*>& ECDB::Query::archetypes() const {
+        return matches;
+    }
+
+    void ECDB::Query::Register(Archetype* archetype) {
+        if (description.Matches(archetype->description.type)) {
+            matches.push_back(archetype);
+        }
+    }
+} // namespace Deep
+
+namespace Deep {
+    template<typename T>
+    ECDB::Prefab& ECDB::Prefab::SetComponent(ComponentId component, const T& value) {
+        Deep_Assert(archetype->database->registry->Get(component).size == sizeof(T),
+                    "Size of type does not match the component.");
+        return SetComponent(component, static_cast<const void*>(&value));
+    }
+
+    const void* ECDB::Prefab::GetComponent(ComponentId component) const {
+        return prototype[archetype->GetComponentOffset(component).column];
+    }
+
+    template<typename T>
+    T ECDB::Prefab::GetComponent(ComponentId component) const {
+        Deep_Assert(archetype->database->registry->Get(component).size == sizeof(T),
+                    "Size of type does not match the component.");
+
+        T value;
+        Memcpy(&value, GetComponent(component), sizeof(T));
+        return value;
+    }
+
+    std::vector<ECDB::Entt> ECDB::Prefab::Instantiate(size_t count) const {
+        return archetype->CreateEntities(count, prototype.data());
+    }
+
+    ECDB::Entt ECDB::Prefab::Instantiate() const {
+        return Instantiate(1)[0];
+    }
 } // namespace Deep
 
 namespace Deep {
@@ -82,6 +512,14 @@ namespace Deep {
         return *rootArchetype;
     }
 
+    ECDB::Archetype* ECDB::GetAddArchetype(Archetype* archetype, ComponentId component) {
+        return GetAddEdge(archetype, component).archetype;
+    }
+
+    ECDB::Archetype* ECDB::GetRemoveArchetype(Archetype* archetype, ComponentId component) {
+        return GetRemoveEdge(archetype, component).archetype;
+    }
+
     void ECDB::Archetype::Remove(EntityPtr* entity) {
         database->rootArchetype->Move(entity);
     }
@@ -117,17 +555,20 @@ namespace Deep {
     }
 
     template<typename T>
-    T* ECDB::Archetype::GetCompList(Chunk* chunk, ComponentOffset offset) {
+    T* ECDB::Archetype::GetCompList(Chunk* chunk, ComponentOffset offset) const {
+        if (!std::is_const<T>::value) MarkChanged(chunk, offset);
         return reinterpret_cast<T*>(GetCompList(chunk, offset));
     }
 
     void* ECDB::Archetype::GetComponent(EntityPtr* entity, ComponentOffset offset) const {
         Deep_Assert(entity->archetype == this, "Entity does not belong to this archetype.");
+        Deep_Assert(offset.lanes == 0, "Laned components are not stored contiguously, use Read / WriteComponent.");
         return entity->chunk + offset.offset + entity->index * offset.size;
     }
 
     template<typename T>
     T& ECDB::Archetype::GetComponent(EntityPtr* entity, ComponentOffset offset) const {
+        if (!std::is_const<T>::value) MarkChanged(entity->chunk, offset);
         return *reinterpret_cast<T*>(GetComponent(entity, offset));
     }
 
@@ -137,7 +578,213 @@ namespace Deep {
 
     template<typename T>
     T& ECDB::Archetype::GetComponent(EntityPtr* entity, ComponentId component) const {
-        return *reinterpret_cast<T*>(GetComponent(entity, GetComponentOffset(component)));
+        return GetComponent<T>(entity, GetComponentOffset(component));
+    }
+
+    template<typename Field, size_t Lanes>
+    ECDB::LaneColumn<Field, Lanes> ECDB::Archetype::GetLaneColumn(Chunk* chunk, ComponentOffset offset,
+                                                                  size_t size) const {
+        Deep_Assert(offset.lanes == Lanes && offset.fieldSize == sizeof(Field),
+                    "Lane layout does not match the component.");
+        if (!std::is_const<Field>::value) MarkChanged(chunk, offset);
+        return LaneColumn<Field, Lanes>{ reinterpret_cast<uint8*>(GetCompList(chunk, offset)),
+                                         offset.size / offset.fieldSize, size };
+    }
+
+    void ECDB::Archetype::ReadComponent(EntityPtr* entity, ComponentOffset offset, void* woValue) const {
+        Deep_Assert(entity->archetype == this, "Entity does not belong to this archetype.");
+        CopyComponent(reinterpret_cast<uint8*>(woValue), 0, 0, entity->chunk + offset.offset, entity->index,
+                      offset.lanes, offset.size, offset.fieldSize);
+    }
+
+    template<typename T>
+    T ECDB::Archetype::ReadComponent(EntityPtr* entity, ComponentId component) const {
+        ComponentOffset offset = GetComponentOffset(component);
+        Deep_Assert(offset.size == sizeof(T), "Size of type does not match the component.");
+
+        T value;
+        ReadComponent(entity, offset, &value);
+        return value;
+    }
+
+    void ECDB::Archetype::WriteComponent(EntityPtr* entity, ComponentOffset offset, const void* value) const {
+        Deep_Assert(entity->archetype == this, "Entity does not belong to this archetype.");
+        MarkChanged(entity->chunk, offset);
+        CopyComponent(entity->chunk + offset.offset, entity->index, offset.lanes, reinterpret_cast<const uint8*>(value),
+                      0, 0, offset.size, offset.fieldSize);
+    }
+
+    template<typename T>
+    void ECDB::Archetype::WriteComponent(EntityPtr* entity, ComponentId component, const T& value) const {
+        ComponentOffset offset = GetComponentOffset(component);
+        Deep_Assert(offset.size == sizeof(T), "Size of type does not match the component.");
+
+        WriteComponent(entity, offset, &value);
+    }
+
+    const void* ECDB::Archetype::GetSharedComponent(ComponentId component) const {
+        return description.GetSharedComponent(component);
+    }
+
+    template<typename T>
+    const T& ECDB::Archetype::GetSharedComponent(ComponentId component) const {
+        Deep_Assert(database->registry->Get(component).size == sizeof(T), "Size of type does not match the component.");
+        return *reinterpret_cast<const T*>(GetSharedComponent(component));
+    }
+
+    void* ECDB::Archetype::GetChunkComponent(Chunk* chunk, ComponentId component) const {
+        Deep_Assert(chunk != nullptr, "Chunk cannot be a nullptr.");
+        const size_t* offset = chunkOffsets.Find(component);
+        Deep_Assert(offset != nullptr, "Archetype does not contain the chunk component.");
+        Preserve(chunk);
+        return chunk + *offset;
+    }
+
+    template<typename T>
+    T& ECDB::Archetype::GetChunkComponent(Chunk* chunk, ComponentId component) const {
+        Deep_Assert(chunk != nullptr, "Chunk cannot be a nullptr.");
+        Deep_Assert(database->registry->Get(component).size == sizeof(T), "Size of type does not match the component.");
+        const size_t* offset = chunkOffsets.Find(component);
+        Deep_Assert(offset != nullptr, "Archetype does not contain the chunk component.");
+        if (!std::is_const<T>::value) Preserve(chunk);
+        return *reinterpret_cast<T*>(chunk + *offset);
+    }
+
+    std::atomic<uint64>& ECDB::Archetype::GetEpoch(Chunk* chunk) const {
+        return *reinterpret_cast<std::atomic<uint64>*>(chunk + chunkSize + sizeof(Chunk*));
+    }
+
+    size_t ECDB::Archetype::GetChunkComponentsOffset() const {
+        return chunkSize + sizeof(Chunk*) + sizeof(uint64) + columns.size() * sizeof(uint64);
+    }
+
+    void ECDB::Archetype::Preserve(Chunk* chunk) const {
+        // NOTE(randomuserhi): The epoch is only written once the copy is complete (see `ECDB::PreserveChunk`), such
+        //                     that writes following this check never race with the copy.
+        if (GetEpoch(chunk).load(std::memory_order_acquire) != database->forkEpoch) {
+            database->PreserveChunk(this, chunk);
+        }
+    }
+
+    uint64* ECDB::Archetype::GetVersions(Chunk* chunk) const {
+        return reinterpret_cast<uint64*>(chunk + chunkSize + sizeof(Chunk*) + sizeof(uint64));
+    }
+
+    uint64 ECDB::Archetype::GetChangeVersion(Chunk* chunk, ComponentOffset offset) const {
+        Deep_Assert(chunk != nullptr, "Chunk cannot be a nullptr.");
+        Deep_Assert(offset.column < columns.size(), "Column does not exist in this archetype.");
+        return GetVersions(chunk)[offset.column];
+    }
+
+    void ECDB::Archetype::MarkChanged(Chunk* chunk, ComponentOffset offset) const {
+        Deep_Assert(chunk != nullptr, "Chunk cannot be a nullptr.");
+        Deep_Assert(offset.column < columns.size(), "Column does not exist in this archetype.");
+        Preserve(chunk);
+        GetVersions(chunk)[offset.column] = database->version;
+    }
+
+    const uint64* ECDB::Archetype::GetEnabledMask(Chunk* chunk, ComponentOffset offset) {
+        Deep_Assert(chunk != nullptr, "Chunk cannot be a nullptr.");
+        if (offset.mask == 0) return nullptr;
+        return reinterpret_cast<const uint64*>(chunk + offset.mask);
+    }
+
+    bool ECDB::Archetype::GetEnabledBit(Chunk* chunk, size_t mask, size_t index) {
+        const uint64* bits = reinterpret_cast<const uint64*>(chunk + mask);
+        return (bits[index / 64] & (uint64(1) << (index % 64))) != 0;
+    }
+
+    void ECDB::Archetype::CopyComponent(uint8* dst, size_t dstIndex, size_t dstLanes, const uint8* src,
+                                        size_t srcIndex, size_t srcLanes, size_t size, size_t fieldSize) {
+        if (dstLanes == 0 && srcLanes == 0) {
+            Memcpy(dst + dstIndex * size, src + srcIndex * size, size);
+            return;
+        }
+
+        // Copy field by field
+        for (size_t field = 0; field < size / fieldSize; ++field) {
+            Memcpy(dst + GetFieldOffset(dstIndex, field, size, fieldSize, dstLanes),
+                   src + GetFieldOffset(srcIndex, field, size, fieldSize, srcLanes), fieldSize);
+        }
+    }
+
+    void ECDB::Archetype::SwapComponent(uint8* a, size_t aIndex, uint8* b, size_t bIndex, size_t lanes, size_t size,
+                                        size_t fieldSize) {
+        if (lanes == 0) {
+            std::swap_ranges(a + aIndex * size, a + (aIndex + 1) * size, b + bIndex * size);
+            return;
+        }
+
+        // Swap field by field
+        for (size_t field = 0; field < size / fieldSize; ++field) {
+            uint8* aField = a + GetFieldOffset(aIndex, field, size, fieldSize, lanes);
+            std::swap_ranges(aField, aField + fieldSize, b + GetFieldOffset(bIndex, field, size, fieldSize, lanes));
+        }
+    }
+
+    size_t ECDB::Archetype::GetColumnSize(const ComponentDesc& component, size_t count) {
+        // NOTE(randomuserhi): Laned columns are made up of whole blocks of lanes.
+        if (component.lanes != 0) count = (count + component.lanes - 1) / component.lanes * component.lanes;
+        return count * component.size;
+    }
+
+    size_t ECDB::Archetype::GetFieldOffset(size_t index, size_t field, size_t size, size_t fieldSize, size_t lanes) {
+        if (lanes == 0) return index * size + field * fieldSize;
+        return (index / lanes) * lanes * size + field * lanes * fieldSize + (index % lanes) * fieldSize;
+    }
+
+    void ECDB::Archetype::SetEnabledBit(Chunk* chunk, size_t mask, size_t index, bool enabled) {
+        uint64* bits = reinterpret_cast<uint64*>(chunk + mask);
+        uint64 bit = uint64(1) << (index % 64);
+        if (enabled) {
+            bits[index / 64] |= bit;
+        } else {
+            bits[index / 64] &= ~bit;
+        }
+    }
+
+    bool ECDB::Archetype::IsEnabled(EntityPtr* entity, ComponentOffset offset) const {
+        Deep_Assert(entity->archetype == this, "Entity does not belong to this archetype.");
+        return offset.mask == 0 || GetEnabledBit(entity->chunk, offset.mask, entity->index);
+    }
+
+    bool ECDB::Archetype::IsEnabled(EntityPtr* entity, ComponentId component) const {
+        return IsEnabled(entity, GetComponentOffset(component));
+    }
+
+    void ECDB::Archetype::SetEnabled(EntityPtr* entity, ComponentOffset offset, bool enabled) const {
+        Deep_Assert(entity->archetype == this, "Entity does not belong to this archetype.");
+        Deep_Assert(offset.mask != 0, "Component is not enableable.");
+        Preserve(entity->chunk);
+        SetEnabledBit(entity->chunk, offset.mask, entity->index, enabled);
+    }
+
+    void ECDB::Archetype::SetEnabled(EntityPtr* entity, ComponentId component, bool enabled) const {
+        SetEnabled(entity, GetComponentOffset(component), enabled);
+    }
+
+    template<typename Function>
+    void ECDB::Archetype::ForEachEnabled(Chunk* chunk, size_t size, const ComponentOffset* offsets, size_t numOffsets,
+                                         Function&& function) {
+        for (size_t word = 0; word * 64 < size; ++word) {
+            uint64 bits = ~uint64(0);
+
+            // Mask out entities past the end of the chunk
+            size_t remaining = size - word * 64;
+            if (remaining < 64) bits = (uint64(1) << remaining) - 1;
+
+            for (size_t i = 0; i < numOffsets && bits != 0; ++i) {
+                const uint64* mask = GetEnabledMask(chunk, offsets[i]);
+                if (mask != nullptr) bits &= mask[word];
+            }
+
+            while (bits != 0) {
+                function(word * 64 + NumTrailingZeros(bits));
+
+                // Clear lowest set bit
+                bits &= bits - 1;
+            }
+        }
     }
 
     ECDB::Archetype::Chunk* ECDB::Archetype::GetNextChunk(Chunk* chunk) const {
@@ -151,5 +798,6 @@ namespace Deep {
 
 namespace Deep {
     ECDB::Archetype::Archetype(ECDB* database) :
-        database(database), description(database->registry), chunkSize(database->chunkSize) {}
+        database(database), description(database->registry), chunkSize(database->chunkSize),
+        allocationSize(chunkSize + sizeof(Chunk*) + sizeof(uint64)) {}
 } // namespace Deep
\ No newline at end of file
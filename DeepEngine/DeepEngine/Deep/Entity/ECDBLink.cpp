@@ -0,0 +1,236 @@
+/**
+ * ECDBLink
+ */
+
+#include <Deep/Entity.h>
+#include <Deep/Memory.h>
+
+#include <algorithm>
+
+namespace Deep {
+    ECDBLink::ECDBLink(ECDB* source, const ECDB::Query* query, ECDB* destination, ECDB::Archetype* archetype,
+                       ECDB::Archetype::ColumnFunction init) :
+        source(source), query(query), destination(destination), archetype(archetype), init(std::move(init)) {
+        Deep_Assert(source != destination, "Source and destination must be different databases.");
+        Deep_Assert(archetype->database == destination, "Archetype does not belong to the destination database.");
+        Deep_Assert(archetype->size() == 0, "Destination archetype must be empty.");
+
+        // TODO(randomuserhi): Thread Safety
+        destination->links.push_back(this);
+    }
+
+    ECDBLink::~ECDBLink() {
+        std::vector<ECDBLink*>& links = destination->links;
+        links.erase(std::find(links.begin(), links.end(), this));
+    }
+
+    ECDBLink& ECDBLink::Sync(ComponentId sourceComponent, ComponentId destinationComponent) {
+        Deep_Assert(ECRegistry::IsComponent(sourceComponent) && ECRegistry::IsComponent(destinationComponent),
+                    "Only components can be synchronized.");
+        Deep_Assert(archetype->description.HasComponent(destinationComponent),
+                    "Destination archetype does not contain the component.");
+
+#ifdef DEEP_ENABLE_ASSERTS
+        const ComponentDesc& src = source->registry->Get(sourceComponent);
+        const ComponentDesc& dst = destination->registry->Get(destinationComponent);
+        Deep_Assert(src.size == dst.size, "Components must have the same size.");
+        Deep_Assert(src.lanes == 0 || dst.lanes == 0 || src.fieldSize == dst.fieldSize,
+                    "Laned components must have the same field size.");
+#endif
+
+        components.emplace_back(sourceComponent, destinationComponent);
+        return *this;
+    }
+
+    bool ECDBLink::Update() {
+        Deep_Assert(archetype->size() == order.size(), "Destination archetype was modified outside of the link.");
+
+        // Check if the order of the source entities still matches
+        // NOTE(randomuserhi): The list of chunks is organised from tail -> head, so only the first chunk is partially
+        //                     filled.
+        size_t numSource = 0;
+        bool matches = true;
+        for (const ECDB::Archetype* src : query->archetypes()) {
+            size_t size = src->firstFreeItemInNewChunk;
+            for (ECDB::Archetype::Chunk* chunk = src->tail; chunk != nullptr && matches;
+                 chunk = src->GetNextChunk(chunk)) {
+                const ECDB::Archetype::Metadata* metadata = ECDB::Archetype::GetMetaList(chunk);
+                for (size_t i = 0; i < size && matches; ++i) {
+                    matches = numSource + i < order.size()
+                           && source->GetHandle(metadata[i].entt) == order[numSource + i];
+                }
+                numSource += size;
+                size = src->entitiesPerChunk;
+            }
+            if (!matches) break;
+        }
+        if (matches && numSource == order.size()) return false;
+
+        // Gather the source entities in order, pairing them with their existing destination entities
+        std::vector<EntityHandle> current;
+        current.reserve(query->size());
+        for (const ECDB::Archetype* src : query->archetypes()) {
+            size_t size = src->firstFreeItemInNewChunk;
+            for (ECDB::Archetype::Chunk* chunk = src->tail; chunk != nullptr; chunk = src->GetNextChunk(chunk)) {
+                const ECDB::Archetype::Metadata* metadata = ECDB::Archetype::GetMetaList(chunk);
+                for (size_t i = 0; i < size; ++i) {
+                    current.push_back(source->GetHandle(metadata[i].entt));
+                }
+                size = src->entitiesPerChunk;
+            }
+        }
+
+        std::vector<ECDB::EntityPtr*> targets(current.size(), nullptr);
+        size_t numCreated = 0;
+        for (size_t i = 0; i < current.size(); ++i) {
+            EntityHandle handle = current[i];
+            if (handle.GetIndex() >= links.size()) {
+                links.resize(handle.GetIndex() + 1, Link{ EntityHandle{}, nullptr, false });
+            }
+
+            Link& link = links[handle.GetIndex()];
+            if (link.source == handle) {
+                link.visited = true;
+                targets[i] = link.destination;
+            } else {
+                ++numCreated;
+            }
+        }
+
+        // Destroy the destination entities of source entities that were destroyed or no longer match the query
+        for (EntityHandle handle : order) {
+            Link& link = links[handle.GetIndex()];
+            if (link.source != handle) continue;
+
+            if (link.visited) {
+                link.visited = false;
+            } else {
+                destination->Destroy(link.destination);
+                link.source = EntityHandle{};
+                link.destination = nullptr;
+            }
+        }
+
+        // Create destination entities for new source entities
+        if (numCreated != 0) {
+            std::vector<ECDB::Entt> created = archetype->CreateEntities(numCreated, init);
+
+            size_t next = 0;
+            for (size_t i = 0; i < current.size(); ++i) {
+                if (targets[i] != nullptr) continue;
+
+                Link& link = links[current[i].GetIndex()];
+                link.source = current[i];
+                link.destination = created[next++];
+                targets[i] = link.destination;
+            }
+        }
+
+        // Reorder the destination archetype to match the source entities
+        size_t index = 0;
+        size_t size = archetype->firstFreeItemInNewChunk;
+        for (ECDB::Archetype::Chunk* chunk = archetype->tail; chunk != nullptr;
+             chunk = archetype->GetNextChunk(chunk)) {
+            const ECDB::Archetype::Metadata* metadata = ECDB::Archetype::GetMetaList(chunk);
+            for (size_t i = 0; i < size; ++i, ++index) {
+                if (metadata[i].entt != targets[index]) {
+                    archetype->Swap(metadata[i].entt, targets[index]);
+                }
+            }
+            size = archetype->entitiesPerChunk;
+        }
+
+        order = std::move(current);
+
+        Deep_Assert(archetype->size() == order.size(), "Destination archetype should match the source entities.");
+        return true;
+    }
+
+    void ECDBLink::Push() const {
+        Copy(true);
+    }
+
+    void ECDBLink::Pull() const {
+        Copy(false);
+    }
+
+    EntityHandle ECDBLink::GetLinked(EntityHandle source) const {
+        if (source.IsNull() || source.GetIndex() >= links.size()) return EntityHandle{};
+
+        const Link& link = links[source.GetIndex()];
+        if (link.source != source) return EntityHandle{};
+        return destination->GetHandle(link.destination);
+    }
+
+    void ECDBLink::Copy(bool push) const {
+        Deep_Assert(archetype->size() == order.size() && query->size() == order.size(),
+                    "Link must be updated after structural changes prior copying.");
+
+        if (components.empty() || order.empty()) return;
+
+        std::vector<ECDB::Archetype::ComponentOffset> dstOffsets(components.size());
+        for (size_t i = 0; i < components.size(); ++i) {
+            dstOffsets[i] = archetype->GetComponentOffset(components[i].second);
+        }
+        std::vector<ECDB::Archetype::ComponentOffset> srcOffsets(components.size());
+
+        // Walk the chunks of both databases in step, copying the longest run of entities that is contiguous in both
+        ECDB::Archetype::Chunk* dstChunk = archetype->tail;
+        size_t dstSize = archetype->firstFreeItemInNewChunk;
+        size_t dstIndex = 0;
+        for (const ECDB::Archetype* src : query->archetypes()) {
+            if (src->size() == 0) continue;
+
+            for (size_t i = 0; i < components.size(); ++i) {
+                srcOffsets[i] = src->GetComponentOffset(components[i].first);
+            }
+
+            size_t srcSize = src->firstFreeItemInNewChunk;
+            for (ECDB::Archetype::Chunk* srcChunk = src->tail; srcChunk != nullptr;
+                 srcChunk = src->GetNextChunk(srcChunk)) {
+                size_t srcIndex = 0;
+                while (srcIndex < srcSize) {
+                    if (dstIndex == dstSize) {
+                        dstChunk = archetype->GetNextChunk(dstChunk);
+                        dstSize = archetype->entitiesPerChunk;
+                        dstIndex = 0;
+                    }
+
+                    size_t count = std::min(srcSize - srcIndex, dstSize - dstIndex);
+                    for (size_t i = 0; i < components.size(); ++i) {
+                        if (push) {
+                            archetype->MarkChanged(dstChunk, dstOffsets[i]);
+                            CopyColumn(dstChunk, dstIndex, dstOffsets[i], srcChunk, srcIndex, srcOffsets[i], count);
+                        } else {
+                            src->MarkChanged(srcChunk, srcOffsets[i]);
+                            CopyColumn(srcChunk, srcIndex, srcOffsets[i], dstChunk, dstIndex, dstOffsets[i], count);
+                        }
+                    }
+
+                    srcIndex += count;
+                    dstIndex += count;
+                }
+                srcSize = src->entitiesPerChunk;
+            }
+        }
+    }
+
+    void ECDBLink::CopyColumn(ECDB::Archetype::Chunk* dst, size_t dstIndex, ECDB::Archetype::ComponentOffset dstOffset,
+                              ECDB::Archetype::Chunk* src, size_t srcIndex, ECDB::Archetype::ComponentOffset srcOffset,
+                              size_t count) {
+        if (dstOffset.lanes == 0 && srcOffset.lanes == 0) {
+            // Both columns are arrays of whole components, copy the run as a whole
+            Memcpy(dst + dstOffset.offset + dstIndex * dstOffset.size,
+                   src + srcOffset.offset + srcIndex * srcOffset.size, count * dstOffset.size);
+            return;
+        }
+
+        // NOTE(randomuserhi): Laned columns are copied entity by entity (a strided copy per field).
+        size_t fieldSize = dstOffset.lanes != 0 ? dstOffset.fieldSize : srcOffset.fieldSize;
+        for (size_t i = 0; i < count; ++i) {
+            ECDB::Archetype::CopyComponent(dst + dstOffset.offset, dstIndex + i, dstOffset.lanes,
+                                           src + srcOffset.offset, srcIndex + i, srcOffset.lanes, dstOffset.size,
+                                           fieldSize);
+        }
+    }
+} // namespace Deep
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+namespace Deep {
+    size_t ECDBLink::size() const {
+        return order.size();
+    }
+} // namespace Deep
\ No newline at end of file
@@ -26,4 +26,72 @@ namespace Deep {
 
         return id;
     }
+
+    ComponentId ECRegistry::RegisterSharedComponent(size_t size, size_t alignment, const char* name) {
+        Deep_Assert(size > 0, "Shared components must contain data.");
+        Deep_Assert(alignment <= alignof(std::max_align_t),
+                    "Shared components with an alignment larger than std::max_align_t are unsupported.");
+
+        ComponentId id = RegisterComponent(size, alignment, name) | sharedBit;
+
+        // Update the stored id to include the shared bit
+        lookup.back().id = id;
+
+        return id;
+    }
+
+    ComponentId ECRegistry::RegisterEnableableComponent(size_t size, size_t alignment, const char* name) {
+        Deep_Assert(size > 0, "Enableable components must contain data, tags are unsupported.");
+
+        ComponentId id = RegisterComponent(size, alignment, name) | enableableBit;
+
+        // Update the stored id to include the enableable bit
+        lookup.back().id = id;
+
+        return id;
+    }
+
+    ComponentId ECRegistry::RegisterSparseComponent(size_t size, size_t alignment, const char* name) {
+        Deep_Assert(size > 0, "Sparse components must contain data, tags are unsupported.");
+        Deep_Assert(alignment <= alignof(std::max_align_t),
+                    "Sparse components with an alignment larger than std::max_align_t are unsupported.");
+
+        ComponentId id = RegisterComponent(size, alignment, name) | sparseBit;
+
+        // Update the stored id to include the sparse bit
+        lookup.back().id = id;
+
+        return id;
+    }
+
+    ComponentId ECRegistry::RegisterChunkComponent(size_t size, size_t alignment, const char* name) {
+        Deep_Assert(size > 0, "Chunk components must contain data, tags are unsupported.");
+        Deep_Assert(alignment <= DEEP_CACHE_LINE_SIZE,
+                    "Chunk components with an alignment larger than a cache line are unsupported.");
+
+        ComponentId id = RegisterComponent(size, alignment, name) | chunkBit;
+
+        // Update the stored id to include the chunk bit
+        lookup.back().id = id;
+
+        return id;
+    }
+
+    ComponentId ECRegistry::RegisterLanedComponent(size_t size, size_t fieldSize, size_t lanes, const char* name) {
+        Deep_Assert(size > 0 && fieldSize > 0, "Laned components must contain data.");
+        Deep_Assert(size % fieldSize == 0, "Size must be a multiple of the field size.");
+        Deep_Assert(Deep::IsPowerOf2(fieldSize), "Field size should be a power of 2.");
+        Deep_Assert(lanes > 0 && Deep::IsPowerOf2(lanes), "Number of lanes should be a power of 2.");
+        Deep_Assert(lanes * fieldSize <= DEEP_CACHE_LINE_SIZE,
+                    "A lane larger than a cache line is unsupported as lanes are aligned to their size.");
+
+        // NOTE(randomuserhi): Fields are aligned to the size of a lane, so the alignment of the component is that of a
+        //                     field.
+        ComponentId id = RegisterComponent(size, fieldSize, name);
+
+        lookup.back().fieldSize = fieldSize;
+        lookup.back().lanes = lanes;
+
+        return id;
+    }
 } // namespace Deep
\ No newline at end of file
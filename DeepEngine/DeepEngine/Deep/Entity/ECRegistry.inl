@@ -22,6 +22,42 @@ namespace Deep {
         return RegisterTag(name);
     }
 
+    template<typename T>
+    ComponentId ECRegistry::RegisterSharedComponent(const char* name) {
+        static_assert(std::is_trivial<T>(), "Shared component types must be trivial.");
+
+        return RegisterSharedComponent(sizeof(T), alignof(T), name);
+    }
+
+    template<typename T>
+    ComponentId ECRegistry::RegisterEnableableComponent(const char* name) {
+        static_assert(std::is_trivial<T>(), "Component types must be trivial.");
+
+        return RegisterEnableableComponent(sizeof(T), alignof(T), name);
+    }
+
+    template<typename T, typename Field>
+    ComponentId ECRegistry::RegisterLanedComponent(size_t lanes, const char* name) {
+        static_assert(std::is_trivial<T>(), "Component types must be trivial.");
+        static_assert(sizeof(T) % sizeof(Field) == 0, "Component must consist of fields of the given type.");
+
+        return RegisterLanedComponent(sizeof(T), sizeof(Field), lanes, name);
+    }
+
+    template<typename T>
+    ComponentId ECRegistry::RegisterSparseComponent(const char* name) {
+        static_assert(std::is_trivial<T>(), "Component types must be trivial.");
+
+        return RegisterSparseComponent(sizeof(T), alignof(T), name);
+    }
+
+    template<typename T>
+    ComponentId ECRegistry::RegisterChunkComponent(const char* name) {
+        static_assert(std::is_trivial<T>(), "Chunk component types must be trivial.");
+
+        return RegisterChunkComponent(sizeof(T), alignof(T), name);
+    }
+
     const ComponentDesc& ECRegistry::Get(ComponentId id) const {
         Deep_Assert(Has(id), "Component does not exist in registry.");
         return lookup[ECRegistry::StripTagBit(id)];
@@ -32,7 +68,23 @@ namespace Deep {
     }
 
     bool ECRegistry::IsComponent(ComponentId id) {
-        return (id & tagBit) == 0;
+        return (id & (tagBit | sharedBit | sparseBit | chunkBit)) == 0;
+    }
+
+    bool ECRegistry::IsShared(ComponentId id) {
+        return (id & sharedBit) == sharedBit;
+    }
+
+    bool ECRegistry::IsEnableable(ComponentId id) {
+        return (id & enableableBit) == enableableBit;
+    }
+
+    bool ECRegistry::IsSparse(ComponentId id) {
+        return (id & sparseBit) == sparseBit;
+    }
+
+    bool ECRegistry::IsChunk(ComponentId id) {
+        return (id & chunkBit) == chunkBit;
     }
 
     bool ECRegistry::IsTag(ComponentId id) {
@@ -40,7 +92,7 @@ namespace Deep {
     }
 
     ComponentId ECRegistry::StripTagBit(ComponentId id) {
-        return id & (~tagBit);
+        return id & (~(tagBit | sharedBit | enableableBit | sparseBit | chunkBit));
     }
 } // namespace Deep
 
@@ -65,6 +117,46 @@ namespace Deep {
         return lookup[idx] = registry->RegisterTag<T>(typeid(T).name());
     }
 
+    template<typename T>
+    ComponentId ECStaticRegistry::RegisterSharedComponent() {
+        std::type_index idx = std::type_index(typeid(T));
+        Deep_Assert(lookup.find(idx) == lookup.end(), "Shared component already exists.");
+
+        return lookup[idx] = registry->RegisterSharedComponent<T>(typeid(T).name());
+    }
+
+    template<typename T>
+    ComponentId ECStaticRegistry::RegisterEnableableComponent() {
+        std::type_index idx = std::type_index(typeid(T));
+        Deep_Assert(lookup.find(idx) == lookup.end(), "Component already exists.");
+
+        return lookup[idx] = registry->RegisterEnableableComponent<T>(typeid(T).name());
+    }
+
+    template<typename T, typename Field>
+    ComponentId ECStaticRegistry::RegisterLanedComponent(size_t lanes) {
+        std::type_index idx = std::type_index(typeid(T));
+        Deep_Assert(lookup.find(idx) == lookup.end(), "Component already exists.");
+
+        return lookup[idx] = registry->RegisterLanedComponent<T, Field>(lanes, typeid(T).name());
+    }
+
+    template<typename T>
+    ComponentId ECStaticRegistry::RegisterSparseComponent() {
+        std::type_index idx = std::type_index(typeid(T));
+        Deep_Assert(lookup.find(idx) == lookup.end(), "Component already exists.");
+
+        return lookup[idx] = registry->RegisterSparseComponent<T>(typeid(T).name());
+    }
+
+    template<typename T>
+    ComponentId ECStaticRegistry::RegisterChunkComponent() {
+        std::type_index idx = std::type_index(typeid(T));
+        Deep_Assert(lookup.find(idx) == lookup.end(), "Chunk component already exists.");
+
+        return lookup[idx] = registry->RegisterChunkComponent<T>(typeid(T).name());
+    }
+
     template<typename T>
     ComponentId ECStaticRegistry::Get() {
         std::type_index idx = std::type_index(typeid(T));
@@ -0,0 +1,224 @@
+/**
+ * ECDB Fork
+ */
+
+#include <Deep/Entity.h>
+#include <Deep/Memory.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+// Class ChunkCopy
+namespace Deep {
+    ECDB::ForkState::ChunkCopy::ChunkCopy(size_t size) :
+        data(reinterpret_cast<uint8*>(AlignedMalloc(size, DEEP_CACHE_LINE_SIZE))) {
+        Deep_Assert(data != nullptr, "Allocated chunk copy should not be a nullptr.");
+    }
+
+    ECDB::ForkState::ChunkCopy::~ChunkCopy() {
+        AlignedFree(data);
+    }
+} // namespace Deep
+
+// Fork / Restore
+namespace Deep {
+    ECDB::ForkState* ECDB::Fork() {
+        // TODO(randomuserhi): Thread Safety
+
+        ForkState* fork = new ForkState(this);
+
+        // Chunks preserved prior this epoch may be shared with the new fork
+        ++forkEpoch;
+
+        for (const auto& kv : archetypes) {
+            Archetype* archetype = kv.second;
+            if (archetype->numEntities == 0) continue;
+
+            fork->archetypes.push_back({ archetype, archetype->numEntities, archetype->firstFreeItemInNewChunk, {} });
+            ForkState::ArchetypeState& state = fork->archetypes.back();
+            for (Archetype::Chunk* chunk = archetype->tail; chunk != nullptr; chunk = archetype->GetNextChunk(chunk)) {
+                state.chunks.push_back({ chunk, nullptr });
+            }
+        }
+
+        fork->generations.resize(numEntitySlots);
+        for (uint32 i = 0; i < numEntitySlots; ++i) {
+            fork->generations[i] = GetEntitySlot(i).generation;
+        }
+
+        // NOTE(randomuserhi): Sparse sets are copied eagerly as they are expected to be small (high churn components).
+        for (const ComponentMap<SparseSet*>::Entry& entry : sparseSets.entries()) {
+            fork->sparseSets.emplace_back(entry.id, *entry.value);
+        }
+
+        // NOTE(randomuserhi): References are registered once all states are constructed such that they remain stable.
+        for (ForkState::ArchetypeState& state : fork->archetypes) {
+            for (ForkState::ChunkRef& ref : state.chunks) {
+                pending[ref.chunk].push_back(&ref);
+            }
+        }
+
+        forks.push_back(fork);
+        return fork;
+    }
+
+    void ECDB::Release(ForkState* fork) {
+        Deep_Assert(fork->database == this, "Fork does not belong to this database.");
+
+        for (ForkState::ArchetypeState& state : fork->archetypes) {
+            for (ForkState::ChunkRef& ref : state.chunks) {
+                if (ref.copy != nullptr) continue;
+
+                auto it = pending.find(ref.chunk);
+                Deep_Assert(it != pending.end(), "Chunk should be shared with the fork.");
+
+                std::vector<ForkState::ChunkRef*>& refs = it->second;
+                refs.erase(std::find(refs.begin(), refs.end(), &ref));
+                if (refs.empty()) pending.erase(it);
+            }
+        }
+
+        forks.erase(std::find(forks.begin(), forks.end(), fork));
+        delete fork;
+    }
+
+    void ECDB::PreserveChunk(const Archetype* archetype, Archetype::Chunk* chunk) {
+        std::lock_guard<std::mutex> lock(preserveMutex);
+
+        // Another thread may have preserved the chunk whilst waiting on the lock
+        std::atomic<uint64>& epoch = archetype->GetEpoch(chunk);
+        if (epoch.load(std::memory_order_relaxed) == forkEpoch) return;
+
+        auto it = pending.find(chunk);
+        if (it == pending.end()) {
+            epoch.store(forkEpoch, std::memory_order_release);
+            return;
+        }
+
+        // A single copy is shared by all forks referencing the chunk
+        // NOTE(randomuserhi): The chunk components are copied right after the data-region.
+        size_t chunkComponents = archetype->GetChunkComponentsOffset();
+        size_t chunkComponentsSize = archetype->allocationSize - chunkComponents;
+        ForkState::ChunkCopy* copy = new ForkState::ChunkCopy(chunkSize + chunkComponentsSize);
+        Memcpy(copy->data, chunk, chunkSize);
+        Memcpy(copy->data + chunkSize, chunk + chunkComponents, chunkComponentsSize);
+
+        for (ForkState::ChunkRef* ref : it->second) {
+            ref->copy = copy;
+        }
+
+        pending.erase(it);
+        epoch.store(forkEpoch, std::memory_order_release);
+    }
+
+    void ECDB::Restore(const ForkState* fork) {
+        // TODO(randomuserhi): Thread Safety
+
+        Deep_Assert(fork->database == this, "Fork does not belong to this database.");
+
+        // Chunks that still hold the contents of the fork are relinked in place
+        std::unordered_set<Archetype::Chunk*> inPlace;
+        for (const ForkState::ArchetypeState& state : fork->archetypes) {
+            for (const ForkState::ChunkRef& ref : state.chunks) {
+                if (ref.copy == nullptr) inPlace.insert(ref.chunk);
+            }
+        }
+
+        // Empty all archetypes, releasing chunks that are not relinked in place to the chunk pool
+        //
+        // NOTE(randomuserhi): Chunks that are relinked in place are never freed (freeing a chunk preserves it for
+        //                     forks), so they are always part of the chunk list of an archetype.
+        for (const auto& kv : archetypes) {
+            Archetype* archetype = kv.second;
+
+            Archetype::Chunk* chunk = archetype->tail;
+            archetype->tail = nullptr;
+            archetype->numEntities = 0;
+            archetype->firstFreeItemInNewChunk = 0;
+
+            while (chunk != nullptr) {
+                Archetype::Chunk* next = archetype->GetNextChunk(chunk);
+                if (inPlace.find(chunk) == inPlace.end()) {
+                    archetype->FreeChunk(chunk);
+                }
+                chunk = next;
+            }
+        }
+
+        // Free all entities, restored entities are revalidated below
+        //
+        // NOTE(randomuserhi): Freeing increments the generation of slots in use such that handles to entities created
+        //                     after the fork are invalidated.
+        for (uint32 i = 0; i < numEntitySlots; ++i) {
+            EntitySlot& slot = GetEntitySlot(i);
+            if (slot.nextFree == usedSlot) {
+                slot.generation = (slot.generation + 1) & EntityHandle::generationMask;
+            }
+            slot.ptr.archetype = nullptr;
+            slot.nextFree = noSlot;
+        }
+
+        // Rebuild the chunk lists of the fork
+        for (const ForkState::ArchetypeState& state : fork->archetypes) {
+            Archetype* archetype = state.archetype;
+
+            // NOTE(randomuserhi): Chunks are appended from head -> tail such that the chunk list has the same order.
+            for (size_t i = state.chunks.size(); i-- > 0;) {
+                const ForkState::ChunkRef& ref = state.chunks[i];
+
+                Archetype::Chunk* chunk;
+                if (ref.copy == nullptr) {
+                    chunk = ref.chunk;
+                    archetype->SetNextChunk(chunk, archetype->tail);
+                    archetype->tail = chunk;
+                    archetype->MarkChunkChanged(chunk);
+                } else {
+                    chunk = archetype->AllocateChunk();
+                    size_t chunkComponents = archetype->GetChunkComponentsOffset();
+                    Memcpy(chunk, ref.copy->data, chunkSize);
+                    Memcpy(chunk + chunkComponents, ref.copy->data + chunkSize,
+                           archetype->allocationSize - chunkComponents);
+                }
+
+                // Revalidate entities
+                size_t size = i == 0 ? state.firstFreeItemInNewChunk : archetype->entitiesPerChunk;
+                const Archetype::Metadata* metadata = Archetype::GetMetaList(chunk);
+                for (size_t j = 0; j < size; ++j) {
+                    EntityPtr* entity = metadata[j].entt;
+                    entity->archetype = archetype;
+                    entity->chunk = chunk;
+                    entity->index = j;
+
+                    // Handles taken prior the fork remain valid
+                    EntitySlot* slot = GetEntitySlot(entity);
+                    slot->generation = fork->generations[slot->index];
+                    slot->nextFree = usedSlot;
+                }
+            }
+
+            archetype->numEntities = state.numEntities;
+            archetype->firstFreeItemInNewChunk = state.firstFreeItemInNewChunk;
+        }
+
+        // Restore sparse components, the restored entities keep their slots so the keys remain valid
+        for (const ComponentMap<SparseSet*>::Entry& entry : sparseSets.entries()) {
+            entry.value->Clear();
+        }
+        for (const std::pair<ComponentId, SparseSet>& state : fork->sparseSets) {
+            *FindSparseSet(state.first) = state.second;
+        }
+
+        // Rebuild the free list of the entity lookup from the slots that were not revalidated
+        firstFree = noSlot;
+        for (uint32 i = numEntitySlots; i-- > 0;) {
+            EntitySlot& slot = GetEntitySlot(i);
+            if (slot.nextFree == usedSlot) continue;
+
+            slot.nextFree = firstFree;
+            firstFree = i;
+        }
+
+        // The event logs describe changes made after the fork, which have been undone
+        ClearEvents();
+    }
+} // namespace Deep
\ No newline at end of file
@@ -0,0 +1,421 @@
+/**
+ * ECDB Snapshot
+ */
+
+#include <Deep/Entity.h>
+#include <Deep/Math.h>
+#include <Deep/Memory.h>
+
+// NOTE(randomuserhi): Layout of a snapshot:
+//
+// Header
+// - uint32 magic, uint32 format version
+// - uint64 chunkSize
+// - uint64 number of components, followed by (ComponentId id, uint64 size, uint64 alignment, uint64 fieldSize,
+//   uint64 lanes) per component
+// - uint64 number of entities
+// - uint64 number of archetypes
+//
+// Per archetype
+// - uint64 number of components in layout, followed by the ComponentIds in layout order
+// - uint64 number of tags / shared components, followed by their ComponentIds
+// - The value of each shared component (in the order of the ComponentIds above)
+// - uint64 entitiesPerChunk
+// - uint64 number of entities
+// - uint64 number of chunks
+// - Padding to DEEP_CACHE_LINE_SIZE
+// - Raw bytes of each chunk (data-region only) from head -> tail, such that only the last chunk is partially filled
+// - Raw bytes of the chunk components of each chunk (in the same order)
+//
+// Sparse components
+// - uint64 number of sparse components
+// - Per sparse component: ComponentId, uint64 number of values, followed by the uint64 index of the entity within the
+//   snapshot of each value and then the values themselves
+
+namespace Deep {
+    static const uint32 snapshotMagic = 0x4E535044; // "DPSN"
+    static const uint32 snapshotFormat = 4;
+
+    void ECDB::SaveSnapshot(std::vector<uint8>& woData) const {
+        woData.clear();
+
+        auto write = [&woData](const void* data, size_t size) {
+            size_t offset = woData.size();
+            woData.resize(offset + size);
+            Memcpy(woData.data() + offset, data, size);
+        };
+        auto writeUInt64 = [&write](uint64 value) { write(&value, sizeof(uint64)); };
+
+        // Header
+        write(&snapshotMagic, sizeof(uint32));
+        write(&snapshotFormat, sizeof(uint32));
+        writeUInt64(chunkSize);
+
+        size_t numComponents = 0;
+        while (registry->Has(static_cast<ComponentId>(numComponents))) {
+            ++numComponents;
+        }
+        writeUInt64(numComponents);
+        for (size_t i = 0; i < numComponents; ++i) {
+            const ComponentDesc& desc = registry->Get(static_cast<ComponentId>(i));
+            write(&desc.id, sizeof(ComponentId));
+            writeUInt64(desc.size);
+            writeUInt64(desc.alignment);
+            writeUInt64(desc.fieldSize);
+            writeUInt64(desc.lanes);
+        }
+
+        size_t numEntities = 0;
+        size_t numArchetypes = 0;
+        for (const auto& kv : archetypes) {
+            if (kv.second->numEntities == 0) continue;
+            numEntities += kv.second->numEntities;
+            ++numArchetypes;
+        }
+        writeUInt64(numEntities);
+        writeUInt64(numArchetypes);
+
+        // Index of the next entity within the snapshot
+        size_t index = 0;
+
+        // Index within the snapshot of the entity in each slot, used to remap the keys of sparse components
+        std::vector<uint32> indices(numEntitySlots, uint32{ noSlot });
+
+        std::vector<Archetype::Chunk*> chunks;
+        std::vector<ComponentId> other;
+        for (const auto& kv : archetypes) {
+            const Archetype& archetype = *kv.second;
+            if (archetype.numEntities == 0) continue;
+
+            const ArchetypeDesc& description = archetype.description;
+
+            writeUInt64(description.layout.size());
+            for (const ComponentDesc& comp : description.layout) {
+                write(&comp.id, sizeof(ComponentId));
+            }
+
+            // Tags and shared components
+            other.clear();
+            for (size_t i = 0; i < numComponents; ++i) {
+                ComponentId id = registry->Get(static_cast<ComponentId>(i)).id;
+                if (description.HasComponent(id) && !ECRegistry::IsComponent(id)) other.push_back(id);
+            }
+            writeUInt64(other.size());
+            for (ComponentId id : other) {
+                write(&id, sizeof(ComponentId));
+            }
+            for (ComponentId id : other) {
+                if (ECRegistry::IsShared(id)) write(description.GetSharedComponent(id), registry->Get(id).size);
+            }
+
+            writeUInt64(archetype.entitiesPerChunk);
+            writeUInt64(archetype.numEntities);
+
+            // NOTE(randomuserhi): The chunk list is organised from tail -> head, chunks are written from head -> tail
+            //                     such that they can be appended in order on load.
+            chunks.clear();
+            for (Archetype::Chunk* chunk = archetype.tail; chunk != nullptr; chunk = archetype.GetNextChunk(chunk)) {
+                chunks.push_back(chunk);
+            }
+            writeUInt64(chunks.size());
+
+            // Align chunk bytes
+            size_t padding = (DEEP_CACHE_LINE_SIZE - (woData.size() % DEEP_CACHE_LINE_SIZE)) % DEEP_CACHE_LINE_SIZE;
+            woData.resize(woData.size() + padding, 0);
+
+            for (size_t i = chunks.size(); i-- > 0;) {
+                size_t size = i == 0 ? archetype.firstFreeItemInNewChunk : archetype.entitiesPerChunk;
+
+                size_t offset = woData.size();
+                write(chunks[i], chunkSize);
+
+                // Replace pointers to entities with their index within the snapshot
+                const Archetype::Metadata* entities = Archetype::GetMetaList(chunks[i]);
+                Archetype::Metadata* metadata = reinterpret_cast<Archetype::Metadata*>(woData.data() + offset);
+                for (size_t j = 0; j < archetype.entitiesPerChunk; ++j) {
+                    if (j < size) {
+                        indices[GetEntitySlot(entities[j].entt)->index] = static_cast<uint32>(index);
+                        metadata[j].entt = reinterpret_cast<EntityPtr*>(index++);
+                    } else {
+                        metadata[j].entt = nullptr;
+                    }
+                }
+            }
+
+            // Chunk components are stored in the chunk header, after the data-region
+            size_t chunkComponents = archetype.GetChunkComponentsOffset();
+            for (size_t i = chunks.size(); i-- > 0;) {
+                write(chunks[i] + chunkComponents, archetype.allocationSize - chunkComponents);
+            }
+        }
+
+        Deep_Assert(index == numEntities, "All entities should have been written.");
+
+        // Sparse components, keyed by the index of the entity within the snapshot
+        size_t numSparse = 0;
+        for (const ComponentMap<SparseSet*>::Entry& entry : sparseSets.entries()) {
+            if (entry.value->size() != 0) ++numSparse;
+        }
+        writeUInt64(numSparse);
+        for (const ComponentMap<SparseSet*>::Entry& entry : sparseSets.entries()) {
+            const SparseSet& set = *entry.value;
+            if (set.size() == 0) continue;
+
+            write(&entry.id, sizeof(ComponentId));
+            writeUInt64(set.size());
+            for (size_t i = 0; i < set.size(); ++i) {
+                Deep_Assert(indices[set.GetKey(i)] != noSlot, "Sparse component belongs to a destroyed entity.");
+                writeUInt64(indices[set.GetKey(i)]);
+            }
+
+            size_t valueSize = registry->Get(entry.id).size;
+            for (size_t i = 0; i < set.size(); ++i) {
+                write(set.GetValue(i), valueSize);
+            }
+        }
+    }
+
+    bool ECDB::LoadSnapshot(const void* data, size_t size) {
+        // TODO(randomuserhi): Thread Safety
+
+        const uint8* bytes = reinterpret_cast<const uint8*>(data);
+        size_t offset = 0;
+
+        auto read = [bytes, size, &offset](void* woData, size_t numBytes) {
+            if (numBytes > size - offset) return false;
+            Memcpy(woData, bytes + offset, numBytes);
+            offset += numBytes;
+            return true;
+        };
+        auto readUInt64 = [&read](size_t& woValue) {
+            uint64 value;
+            if (!read(&value, sizeof(uint64))) return false;
+            woValue = static_cast<size_t>(value);
+            return true;
+        };
+
+        // Header
+        uint32 magic;
+        uint32 format;
+        size_t snapshotChunkSize;
+        if (!read(&magic, sizeof(uint32)) || !read(&format, sizeof(uint32))) return false;
+        if (!readUInt64(snapshotChunkSize)) return false;
+        if (magic != snapshotMagic || format != snapshotFormat || snapshotChunkSize != chunkSize) return false;
+
+        size_t numComponents;
+        if (!readUInt64(numComponents)) return false;
+        for (size_t i = 0; i < numComponents; ++i) {
+            ComponentId id;
+            size_t compSize;
+            size_t alignment;
+            size_t fieldSize;
+            size_t lanes;
+            if (!read(&id, sizeof(ComponentId)) || !readUInt64(compSize) || !readUInt64(alignment)) return false;
+            if (!readUInt64(fieldSize) || !readUInt64(lanes)) return false;
+
+            if (!registry->Has(static_cast<ComponentId>(i))) return false;
+            const ComponentDesc& desc = registry->Get(static_cast<ComponentId>(i));
+            if (desc.id != id || desc.size != compSize || desc.alignment != alignment) return false;
+            if (desc.fieldSize != fieldSize || desc.lanes != lanes) return false;
+        }
+
+        size_t numEntities;
+        size_t numArchetypes;
+        if (!readUInt64(numEntities) || !readUInt64(numArchetypes)) return false;
+
+        // Entities of an archetype within the snapshot
+        struct Record {
+            ArchetypeDesc description;
+            size_t entitiesPerChunk;
+            size_t numEntities;
+            size_t numChunks;
+            const uint8* chunks;
+            const uint8* chunkComponents;
+        };
+
+        // Validate the archetype table prior loading any entities
+        // NOTE(randomuserhi): Archetypes are only created once the whole snapshot is validated, such that a malformed
+        //                     snapshot leaves the database untouched.
+        std::vector<Record> records;
+        size_t total = 0;
+        for (size_t i = 0; i < numArchetypes; ++i) {
+            ArchetypeDesc description{ registry };
+
+            size_t numLayout;
+            if (!readUInt64(numLayout)) return false;
+            for (size_t j = 0; j < numLayout; ++j) {
+                ComponentId id;
+                if (!read(&id, sizeof(ComponentId))) return false;
+                if (!registry->Has(id) || registry->Get(id).id != id || !ECRegistry::IsComponent(id)) return false;
+                if (description.HasComponent(id)) return false;
+                description.AddComponent(id);
+            }
+
+            size_t numOther;
+            if (!readUInt64(numOther) || numOther > (size - offset) / sizeof(ComponentId)) return false;
+            std::vector<ComponentId> other(numOther);
+            for (size_t j = 0; j < numOther; ++j) {
+                ComponentId id;
+                if (!read(&id, sizeof(ComponentId))) return false;
+                if (!registry->Has(id) || registry->Get(id).id != id || ECRegistry::IsComponent(id)) return false;
+                other[j] = id;
+            }
+            for (ComponentId id : other) {
+                if (description.HasComponent(id)) return false;
+
+                if (ECRegistry::IsShared(id)) {
+                    size_t valueSize = registry->Get(id).size;
+                    if (valueSize > size - offset) return false;
+                    description.SetSharedComponent(id, bytes + offset);
+                    offset += valueSize;
+                } else {
+                    description.AddComponent(id);
+                }
+            }
+
+            size_t entitiesPerChunk;
+            size_t count;
+            size_t numChunks;
+            if (!readUInt64(entitiesPerChunk) || !readUInt64(count) || !readUInt64(numChunks)) return false;
+
+            offset += (DEEP_CACHE_LINE_SIZE - (offset % DEEP_CACHE_LINE_SIZE)) % DEEP_CACHE_LINE_SIZE;
+            if (offset > size || numChunks > (size - offset) / chunkSize) return false;
+
+            // Archetypes of the snapshot must not contain entities, otherwise the chunks cannot be appended as is
+            size_t chunkComponentsSize;
+            const Archetype* existing = FindArchetype(description);
+            if (existing != nullptr) {
+                if (existing->numEntities != 0 || existing->entitiesPerChunk != entitiesPerChunk) return false;
+                chunkComponentsSize = existing->allocationSize - existing->GetChunkComponentsOffset();
+            } else {
+                // NOTE(randomuserhi): Constructing an archetype only computes its layout, no chunks are allocated.
+                Archetype layout{ this, ArchetypeDesc{ description } };
+                if (layout.entitiesPerChunk != entitiesPerChunk) return false;
+                chunkComponentsSize = layout.allocationSize - layout.GetChunkComponentsOffset();
+            }
+            if (count == 0 || numChunks != (count + entitiesPerChunk - 1) / entitiesPerChunk) return false;
+
+            for (const Record& record : records) {
+                if (record.description.GetKey() == description.GetKey()) return false;
+            }
+
+            const uint8* chunks = bytes + offset;
+            offset += numChunks * chunkSize;
+            if (chunkComponentsSize != 0 && numChunks > (size - offset) / chunkComponentsSize) return false;
+            const uint8* chunkComponents = bytes + offset;
+            offset += numChunks * chunkComponentsSize;
+
+            records.push_back({ std::move(description), entitiesPerChunk, count, numChunks, chunks, chunkComponents });
+            total += count;
+        }
+        if (total != numEntities) return false;
+
+        // Validate the entity indices stored in the Metadata arrays, each index must appear exactly once
+        std::vector<bool> seen(numEntities, false);
+        for (const Record& record : records) {
+            const uint8* src = record.chunks;
+            size_t remaining = record.numEntities;
+            for (size_t i = 0; i < record.numChunks; ++i) {
+                size_t count = Deep::Min(remaining, record.entitiesPerChunk);
+                for (size_t j = 0; j < count; ++j) {
+                    // NOTE(randomuserhi): The snapshot may not be aligned, hence the copy.
+                    Archetype::Metadata metadata;
+                    Memcpy(&metadata, src + j * sizeof(Archetype::Metadata), sizeof(Archetype::Metadata));
+
+                    size_t index = reinterpret_cast<size_t>(metadata.entt);
+                    if (index >= numEntities || seen[index]) return false;
+                    seen[index] = true;
+                }
+
+                src += chunkSize;
+                remaining -= count;
+            }
+        }
+
+        // Sparse components
+        struct SparseRecord {
+            ComponentId component;
+            size_t count;
+            const uint8* indices;
+            const uint8* values;
+        };
+
+        size_t numSparse;
+        if (!readUInt64(numSparse) || numSparse > size - offset) return false;
+        std::vector<SparseRecord> sparseRecords;
+        for (size_t i = 0; i < numSparse; ++i) {
+            ComponentId id;
+            size_t count;
+            if (!read(&id, sizeof(ComponentId)) || !readUInt64(count)) return false;
+            if (!registry->Has(id) || registry->Get(id).id != id || !ECRegistry::IsSparse(id)) return false;
+            for (const SparseRecord& record : sparseRecords) {
+                if (record.component == id) return false;
+            }
+
+            size_t valueSize = registry->Get(id).size;
+            if (count > numEntities || count > (size - offset) / (sizeof(uint64) + valueSize)) return false;
+
+            // Each entity has atmost 1 value per sparse component
+            const uint8* indices = bytes + offset;
+            seen.assign(numEntities, false);
+            for (size_t j = 0; j < count; ++j) {
+                uint64 index;
+                Memcpy(&index, indices + j * sizeof(uint64), sizeof(uint64));
+                if (index >= numEntities || seen[index]) return false;
+                seen[index] = true;
+            }
+
+            sparseRecords.push_back({ id, count, indices, indices + count * sizeof(uint64) });
+            offset += count * (sizeof(uint64) + valueSize);
+        }
+
+        // Load entities
+        std::vector<EntityPtr*> entities(numEntities);
+        AllocateEntities(entities.data(), numEntities);
+
+        for (const Record& record : records) {
+            Archetype& archetype = GetArchetype(record.description);
+
+            const uint8* src = record.chunks;
+            size_t remaining = record.numEntities;
+            size_t chunkComponents = archetype.GetChunkComponentsOffset();
+            size_t chunkComponentsSize = archetype.allocationSize - chunkComponents;
+            for (size_t i = 0; i < record.numChunks; ++i) {
+                Archetype::Chunk* chunk = archetype.AllocateChunk();
+                Memcpy(chunk, src, chunkSize);
+                Memcpy(chunk + chunkComponents, record.chunkComponents + i * chunkComponentsSize, chunkComponentsSize);
+                src += chunkSize;
+
+                // Rebuild entity pointers
+                size_t count = Deep::Min(remaining, archetype.entitiesPerChunk);
+                Archetype::Metadata* metadata = reinterpret_cast<Archetype::Metadata*>(chunk);
+                for (size_t j = 0; j < count; ++j) {
+                    EntityPtr* entity = entities[reinterpret_cast<size_t>(metadata[j].entt)];
+                    metadata[j].entt = entity;
+
+                    entity->archetype = &archetype;
+                    entity->chunk = chunk;
+                    entity->index = j;
+                }
+
+                archetype.firstFreeItemInNewChunk = count;
+                archetype.numEntities += count;
+                remaining -= count;
+            }
+        }
+
+        for (const SparseRecord& record : sparseRecords) {
+            SparseSet& set = GetSparseSet(record.component);
+            size_t valueSize = registry->Get(record.component).size;
+            for (size_t i = 0; i < record.count; ++i) {
+                uint64 index;
+                Memcpy(&index, record.indices + i * sizeof(uint64), sizeof(uint64));
+
+                uint32 key = GetEntitySlot(entities[static_cast<size_t>(index)])->index;
+                Memcpy(set.Insert(key), record.values + i * valueSize, valueSize);
+            }
+        }
+
+        return true;
+    }
+} // namespace Deep
\ No newline at end of file
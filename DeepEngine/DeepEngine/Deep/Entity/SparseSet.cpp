@@ -0,0 +1,54 @@
+/**
+ * SparseSet
+ */
+
+#include <Deep/Entity.h>
+#include <Deep/Memory.h>
+
+#include <cstring>
+
+namespace Deep {
+    SparseSet::SparseSet(size_t size, size_t alignment) :
+        valueSize(size) {
+        Deep_Assert(size > 0, "Values must contain data.");
+        Deep_Assert(alignment <= alignof(std::max_align_t),
+                    "Values with an alignment larger than std::max_align_t are unsupported.");
+    }
+
+    void* SparseSet::Insert(uint32 key) {
+        Deep_Assert(!Has(key), "Key already exists in the set.");
+
+        size_t page = key / pageSize;
+        if (page >= pages.size()) pages.resize(page + 1);
+        if (pages[page].empty()) pages[page].resize(pageSize, 0);
+
+        size_t index = keys.size();
+        keys.push_back(key);
+        pages[page][key % pageSize] = static_cast<uint32>(index + 1);
+
+        size_t bytes = keys.size() * valueSize;
+        values.resize((bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+
+        void* value = GetValue(index);
+        std::memset(value, 0, valueSize);
+        return value;
+    }
+
+    bool SparseSet::Erase(uint32 key) {
+        size_t index = IndexOf(key);
+        if (index == keys.size()) return false;
+
+        // Swap the last value into the erased slot
+        size_t last = keys.size() - 1;
+        if (index != last) {
+            uint32 lastKey = keys[last];
+            keys[index] = lastKey;
+            Memcpy(GetValue(index), GetValue(last), valueSize);
+            pages[lastKey / pageSize][lastKey % pageSize] = static_cast<uint32>(index + 1);
+        }
+        pages[key / pageSize][key % pageSize] = 0;
+        keys.pop_back();
+
+        return true;
+    }
+} // namespace Deep
\ No newline at end of file
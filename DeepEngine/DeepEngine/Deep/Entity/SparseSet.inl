@@ -0,0 +1,39 @@
+#pragma once
+
+namespace Deep {
+    void* SparseSet::Find(uint32 key) const {
+        size_t index = IndexOf(key);
+        return index != keys.size() ? GetValue(index) : nullptr;
+    }
+
+    bool SparseSet::Has(uint32 key) const {
+        return IndexOf(key) != keys.size();
+    }
+
+    void SparseSet::Clear() {
+        pages.clear();
+        keys.clear();
+        values.clear();
+    }
+
+    size_t SparseSet::size() const {
+        return keys.size();
+    }
+
+    uint32 SparseSet::GetKey(size_t index) const {
+        return keys[index];
+    }
+
+    void* SparseSet::GetValue(size_t index) const {
+        Deep_Assert(index < keys.size(), "Index out of bounds.");
+        return const_cast<uint8*>(reinterpret_cast<const uint8*>(values.data())) + index * valueSize;
+    }
+
+    size_t SparseSet::IndexOf(uint32 key) const {
+        size_t page = key / pageSize;
+        if (page >= pages.size() || pages[page].empty()) return keys.size();
+
+        uint32 index = pages[page][key % pageSize];
+        return index != 0 ? index - 1 : keys.size();
+    }
+} // namespace Deep
\ No newline at end of file
@@ -0,0 +1,74 @@
+/**
+ * SystemScheduler
+ */
+
+#include <Deep/Entity.h>
+
+namespace Deep {
+    bool SystemScheduler::SystemDesc::ConflictsWith(const SystemDesc& other) const {
+        return exclusive || other.exclusive || writes.HasAny(other.writes) || writes.HasAny(other.reads)
+            || other.writes.HasAny(reads);
+    }
+
+    size_t SystemScheduler::Register(SystemDesc&& description, SystemFunction function) {
+        size_t index = systems.size();
+        systems.push_back({ std::move(description), std::move(function), {}, {} });
+        System& system = systems.back();
+
+        // NOTE(randomuserhi): Prior systems are visited latest first. A conflicting system that an already linked
+        //                     system (transitively) waits on is skipped, as the dependency is implied.
+        std::vector<bool> implied(index, false);
+        for (size_t i = index; i-- > 0;) {
+            if (implied[i]) {
+                for (size_t dependency : systems[i].dependencies) {
+                    implied[dependency] = true;
+                }
+                continue;
+            }
+            if (!system.description.ConflictsWith(systems[i].description)) continue;
+
+            system.dependencies.push_back(i);
+            systems[i].dependents.push_back(index);
+
+            for (size_t dependency : systems[i].dependencies) {
+                implied[dependency] = true;
+            }
+        }
+
+        return index;
+    }
+
+    void SystemScheduler::Run() {
+        if (systems.empty()) return;
+
+        Barrier barrier = jobSystem->AcquireBarrier();
+
+        // NOTE(randomuserhi): Each job holds an extra dependency until all jobs are created, such that a job cannot
+        //                     complete (and release its dependents) prior the jobs of its dependents existing.
+        jobs.reserve(systems.size());
+        for (size_t i = 0; i < systems.size(); ++i) {
+            const System& system = systems[i];
+
+            // NOTE(randomuserhi): Capturing `this` is safe as the barrier is waited on prior returning.
+            jobs.push_back(jobSystem->Enqueue(
+                [this, i]() {
+                    const System& system = systems[i];
+                    system.function(*database);
+
+                    for (size_t dependent : system.dependents) {
+                        jobs[dependent].RemoveDependency(1);
+                    }
+                },
+                static_cast<uint32>(system.dependencies.size() + 1)));
+
+            barrier.AddJob(jobs.back());
+        }
+
+        for (const Job& job : jobs) {
+            job.RemoveDependency(1);
+        }
+
+        barrier.Wait();
+        jobs.clear();
+    }
+} // namespace Deep
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+namespace Deep {
+    SystemScheduler::SystemDesc::SystemDesc(ECRegistry* registry) :
+        reads(registry), writes(registry) {}
+
+    SystemScheduler::SystemDesc& SystemScheduler::SystemDesc::Read(ComponentId component) & {
+        if (!reads.HasComponent(component)) reads.AddComponent(component);
+        return *this;
+    }
+
+    SystemScheduler::SystemDesc&& SystemScheduler::SystemDesc::Read(ComponentId component) && {
+        return std::move(Read(component));
+    }
+
+    SystemScheduler::SystemDesc& SystemScheduler::SystemDesc::Write(ComponentId component) & {
+        if (!writes.HasComponent(component)) writes.AddComponent(component);
+        return *this;
+    }
+
+    SystemScheduler::SystemDesc&& SystemScheduler::SystemDesc::Write(ComponentId component) && {
+        return std::move(Write(component));
+    }
+
+    SystemScheduler::SystemDesc& SystemScheduler::SystemDesc::Exclusive() & {
+        exclusive = true;
+        return *this;
+    }
+
+    SystemScheduler::SystemDesc&& SystemScheduler::SystemDesc::Exclusive() && {
+        return std::move(Exclusive());
+    }
+} // namespace Deep
+
+namespace Deep {
+    SystemScheduler::SystemScheduler(ECDB* database, JobSystem* jobSystem) :
+        database(database), jobSystem(jobSystem) {
+        Deep_Assert(jobSystem != nullptr, "JobSystem cannot be a nullptr.");
+    }
+
+    const std::vector<size_t>& SystemScheduler::GetDependencies(size_t system) const {
+        return systems[system].dependencies;
+    }
+
+    size_t SystemScheduler::size() const {
+        return systems.size();
+    }
+} // namespace Deep
\ No newline at end of file
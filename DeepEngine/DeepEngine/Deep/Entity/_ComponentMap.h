@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+
+namespace Deep {
+    // Maps ComponentIds to values, stored contiguously in a single vector.
+    //
+    // A lookup is a single read from a flat table indexed by the stripped ComponentId (relative to the smallest id in
+    // the map). If the ids in the map are sparse such that the table would be mostly empty, the table is dropped and
+    // the entries (kept sorted by id) are binary searched instead.
+    //
+    // This is a more cache efficient `std::unordered_map<ComponentId, T>` specialized for the constraints of:
+    // - ComponentIds are small numbers (indices into the registry)
+    // - Lookups are far more frequent than insertions / removals
+    //
+    // NOTE(randomuserhi): Inserting / erasing invalidates pointers to values.
+    template<typename T>
+    class ComponentMap {
+    public:
+        struct Entry {
+            ComponentId id;
+            T value;
+        };
+
+        // Returns nullptr if `id` does not exist in the map
+        Deep_Inline T* Find(ComponentId id);
+        Deep_Inline const T* Find(ComponentId id) const;
+
+        // `id` must not already exist in the map
+        T& Insert(ComponentId id, T&& value);
+
+        // Returns false if `id` does not exist in the map
+        bool Erase(ComponentId id);
+
+        Deep_Inline const std::vector<Entry>& entries() const;
+
+        Deep_Inline size_t size() const;
+
+    private:
+        // Returns the index of the entry of `id`, or the number of entries if it does not exist
+        Deep_Inline size_t IndexOf(ComponentId id) const;
+
+        // Rebuilds the lookup table after inserting / erasing entries
+        void Rebuild();
+
+        // Tables up to this size are always used regardless of how sparse the ids are
+        static const size_t minTableSize = 64;
+
+        // Tables larger than `maxSparsity` times the number of entries are considered sparse
+        static const size_t maxSparsity = 4;
+
+        // NOTE(randomuserhi): Sorted by stripped ComponentId.
+        std::vector<Entry> items;
+
+        // Index + 1 of the entry of each stripped ComponentId starting at `base`, 0 if the id does not exist in the
+        // map. Empty if the ids are sparse.
+        std::vector<uint32> table;
+        ComponentId base = 0;
+    };
+} // namespace Deep
+
+#include "ComponentMap.inl"
\ No newline at end of file
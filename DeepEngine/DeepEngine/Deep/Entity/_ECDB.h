@@ -4,24 +4,41 @@
 #include <Deep/Bithelper.h>
 #include <Deep/Entity.h>
 
+#include <Deep/Memory/Reference.h>
+#include <Deep/Memory/SlabAllocator.h>
 #include <Deep/NonCopyable.h>
-
+#include <Deep/Threading/JobSystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 // TODO(randomuserhi):
 // - Thread Safe Operations
-// - API to trade chunks between archetypes that share the same layout
-//   (This allows fast bulk moving of entities between archetypes)
 // - Refactor chunk API for better iteration
 
 namespace Deep {
+    // Set of ComponentIds making up the type of an archetype.
+    //
+    // The first `inlineBits` components are stored inline such that copying a bitfield (e.g when deriving the
+    // description of an archetype) does not allocate, components beyond that spill to the heap. The hash is updated
+    // incrementally as components are added / removed, such that looking up an archetype does not rehash the type.
     struct ArchetypeBitField {
         friend struct std::hash<Deep::ArchetypeBitField>;
 
     private:
-        using Type = uint32;
-        static const size_t bitsPerType = 32;
+        using Type = uint64;
+        static const size_t bitsPerType = 64;
+
+        static const size_t inlineBits = 256;
+        static const size_t inlineSize = inlineBits / bitsPerType;
 
     public:
         explicit Deep_Inline ArchetypeBitField(ECRegistry* registry);
@@ -40,22 +57,63 @@ namespace Deep {
 
         ArchetypeBitField& RemoveComponent(ComponentId component);
 
+        // Returns true if every component in `other` is also in this bitfield
+        bool HasAll(const ArchetypeBitField& other) const;
+
+        // Returns true if atleast 1 component in `other` is also in this bitfield
+        bool HasAny(const ArchetypeBitField& other) const;
+
+        // Returns true if the bitfield contains no components
+        bool IsEmpty() const;
+
     private:
+        // Returns the word containing the bit of the stripped ComponentId `component`, nullptr if it is not stored
+        Deep_Inline const Type* GetWord(ComponentId component) const;
+
+        // Sets the word at `index`, updating the cached hash
+        void SetWord(size_t index, Type word);
+
+        // Contribution of the word at `index` to the hash
+        //
+        // NOTE(randomuserhi): Empty words do not contribute such that bitfields with different amounts of spilled
+        //                     words still hash the same.
+        static Deep_Inline size_t HashWord(size_t index, Type word);
+
         ECRegistry* const registry;
 
-        std::vector<Type> bits;
+        alignas(32) Type bits[inlineSize] = {};
+
+        // Words following the inline words, only allocated once a component beyond `inlineBits` is added
+        std::vector<Type> spill;
+
+        size_t hash = 0;
     };
 } // namespace Deep
 
 template<>
 struct std::hash<Deep::ArchetypeBitField> {
     std::size_t operator()(const Deep::ArchetypeBitField& k) const {
-        std::size_t hash = 0;
+        return k.hash;
+    }
+};
+
+namespace Deep {
+    // Identifies an archetype by its type and the values of its shared components
+    struct ArchetypeKey {
+        ArchetypeBitField type;
+        std::vector<uint8> shared;
+    };
+
+    bool operator==(const ArchetypeKey& a, const ArchetypeKey& b);
+} // namespace Deep
+
+template<>
+struct std::hash<Deep::ArchetypeKey> {
+    std::size_t operator()(const Deep::ArchetypeKey& k) const {
+        std::size_t hash = std::hash<Deep::ArchetypeBitField>()(k.type);
 
-        for (size_t i = 0; i < k.bits.size(); ++i) {
-            if (k.bits[i] != 0) {
-                hash ^= std::hash<Deep::ArchetypeBitField::Type>()(k.bits[i]) ^ (i * 0xabefcedf);
-            }
+        for (size_t i = 0; i < k.shared.size(); ++i) {
+            hash = hash * 31 + k.shared[i];
         }
 
         return hash;
@@ -63,10 +121,51 @@ struct std::hash<Deep::ArchetypeBitField> {
 };
 
 namespace Deep {
+    // Compact handle to an entity, packing the index of its slot in the entity lookup table with the generation of the
+    // slot. Unlike `ECDB::Entt`, handles hold no pointers so they can be stored in components or sent over the
+    // network. Destroying an entity increments the generation of its slot, so stale handles are rejected in O(1).
+    //
+    // NOTE(randomuserhi): Define DEEP_ENTITY_HANDLE_32 prior including the header to use 32 bit handles (24 bit index,
+    //                     8 bit generation). Generations wrap around, so a handle that is stale by a multiple of 256
+    //                     frees of its slot aliases the current entity.
+    struct EntityHandle {
+#ifdef DEEP_ENTITY_HANDLE_32
+        using Type = uint32;
+        static const uint32 indexBits = 24;
+#else
+        using Type = uint64;
+        static const uint32 indexBits = 32;
+#endif
+        static const uint32 generationBits = sizeof(Type) * 8 - indexBits;
+
+        static const Type indexMask = (Type(1) << indexBits) - 1;
+        static const Type generationMask = (Type(1) << generationBits) - 1;
+
+        // NOTE(randomuserhi): The last index is reserved for the null handle.
+        static const Type maxIndex = indexMask;
+
+        // Null handle, never refers to an entity
+        Deep_Inline EntityHandle() = default;
+        explicit Deep_Inline EntityHandle(uint32 index, uint32 generation);
+
+        Deep_Inline uint32 GetIndex() const;
+        Deep_Inline uint32 GetGeneration() const;
+
+        Deep_Inline bool IsNull() const;
+
+        friend Deep_Inline bool operator==(EntityHandle a, EntityHandle b);
+        friend Deep_Inline bool operator!=(EntityHandle a, EntityHandle b);
+
+        Type value = ~Type(0);
+    };
 
     // TODO(randomuserhi): Asserts and debug mode memory safety (counting number of delete calls etc...)
 
+    class ECDBLink;
+
     class ECDB final : NonCopyable {
+        friend class ECDBLink;
+
     private:
         struct EntityPtr;
 
@@ -76,10 +175,25 @@ namespace Deep {
 
             Deep_Inline operator ECDB::EntityPtr* const() const;
 
+            // Returns a compact handle to the entity that remains safe to use after the entity is destroyed
+            Deep_Inline EntityHandle GetHandle() const;
+
             Deep_Inline Entt& AddComponent(ComponentId component);
 
             Deep_Inline Entt& RemoveComponent(ComponentId component);
 
+            Deep_Inline Entt& SetSharedComponent(ComponentId component, const void* value);
+
+            template<typename T>
+            Deep_Inline Entt& SetSharedComponent(ComponentId component, const T& value);
+
+            Deep_Inline Entt& SetEnabled(ComponentId component, bool enabled);
+
+            Deep_Inline bool IsEnabled(ComponentId component) const;
+
+            // Destroys the entity, invalidating this handle
+            Deep_Inline void Destroy();
+
         private:
             ECDB* const database;
 
@@ -89,6 +203,21 @@ namespace Deep {
     public:
         class Archetype;
 
+        template<typename... Ts>
+        class View;
+
+    private:
+        struct ParallelChunk;
+
+    public:
+        // Recorded when an entity changes archetype, see `SetEventRecording`
+        struct MoveEvent {
+            EntityHandle entity;
+            const Archetype* from;
+            const Archetype* to;
+        };
+
+    public:
         struct ArchetypeDesc {
             explicit Deep_Inline ArchetypeDesc(ECRegistry* registry);
             Deep_Inline ArchetypeDesc(const ArchetypeDesc&) = default;
@@ -105,18 +234,126 @@ namespace Deep {
             ArchetypeDesc& RemoveComponent(ComponentId component) &;
             Deep_Inline ArchetypeDesc&& RemoveComponent(ComponentId component) &&;
 
+            // Sets the value of a shared component, adding the shared component to the type if it is not present
+            ArchetypeDesc& SetSharedComponent(ComponentId component, const void* value) &;
+            Deep_Inline ArchetypeDesc&& SetSharedComponent(ComponentId component, const void* value) &&;
+
+            const void* GetSharedComponent(ComponentId component) const;
+
+            // Key identifying archetypes of this description
+            Deep_Inline ArchetypeKey GetKey() const;
+
             ECRegistry* const registry;
 
             ArchetypeBitField type;
 
             // NOTE(randomuserhi): The order of which components are added determines the memory layout of the components in
             //                     the chunk.
-            // NOTE(randomuserhi): Does not include tags.
+            // NOTE(randomuserhi): Does not include tags, shared or chunk components.
             std::vector<ComponentDesc> layout;
+
+            // Chunk components, stored in the chunk header in the order they were added
+            std::vector<ComponentDesc> chunkLayout;
+
+            // Shared components in order of ComponentId. Their values are stored in `sharedData` at the matching
+            // `sharedOffsets`.
+            //
+            // NOTE(randomuserhi): Padding within `sharedData` is zeroed such that it can be compared / hashed directly.
+            std::vector<ComponentDesc> sharedLayout;
+            std::vector<size_t> sharedOffsets;
+            std::vector<uint8> sharedData;
+
+        private:
+            // Replaces `sharedLayout`, keeping the values of shared components that remain
+            void SetSharedLayout(std::vector<ComponentDesc>&& layout);
+        };
+
+        struct QueryDesc {
+            explicit Deep_Inline QueryDesc(ECRegistry* registry);
+            Deep_Inline QueryDesc(const QueryDesc&) = default;
+            Deep_Inline QueryDesc(QueryDesc&&) noexcept = default;
+
+            Deep_Inline QueryDesc& operator=(const QueryDesc&) = default;
+            Deep_Inline QueryDesc& operator=(QueryDesc&&) noexcept = default;
+
+            friend bool operator!=(const QueryDesc& a, const QueryDesc& b);
+            friend bool operator==(const QueryDesc& a, const QueryDesc& b);
+
+            // Matching archetypes must contain this component
+            Deep_Inline QueryDesc& With(ComponentId component) &;
+            Deep_Inline QueryDesc&& With(ComponentId component) &&;
+
+            // Matching archetypes must not contain this component
+            Deep_Inline QueryDesc& Without(ComponentId component) &;
+            Deep_Inline QueryDesc&& Without(ComponentId component) &&;
+
+            // Matching archetypes must contain atleast 1 of the components marked as `Any`
+            Deep_Inline QueryDesc& Any(ComponentId component) &;
+            Deep_Inline QueryDesc&& Any(ComponentId component) &&;
+
+            // Matching archetypes must contain this component (implies `With`). When iterating the query with a
+            // `sinceVersion`, chunks are skipped unless atleast 1 of the `Changed` components was written to after
+            // `sinceVersion`.
+            QueryDesc& Changed(ComponentId component) &;
+            Deep_Inline QueryDesc&& Changed(ComponentId component) &&;
+
+            // Returns true if an archetype of the given type satisfies this query
+            Deep_Inline bool Matches(const ArchetypeBitField& type) const;
+
+            ECRegistry* const registry;
+
+            ArchetypeBitField with;
+            ArchetypeBitField without;
+            ArchetypeBitField any;
+
+            // NOTE(randomuserhi): Kept sorted such that descriptions can be compared.
+            std::vector<ComponentId> changed;
+        };
+
+        // Accessor for the column of a laned component within a chunk (see `ECRegistry::RegisterLanedComponent`).
+        //
+        // Block `b` holds the entities [b * Lanes, (b + 1) * Lanes). Within a block, each field of the component is
+        // stored as `Lanes` consecutive values aligned to `Lanes * sizeof(Field)`, such that a field of a whole block
+        // can be loaded with a single aligned SIMD load.
+        //
+        // NOTE(randomuserhi): The last block may be partially filled, lanes past the number of entities in the chunk
+        //                     hold unspecified values which can be processed by SIMD kernels but must be ignored.
+        template<typename Field, size_t Lanes>
+        class LaneColumn {
+        public:
+            Deep_Inline LaneColumn(uint8* data, size_t numFields, size_t size);
+
+            // Number of blocks holding the entities of the chunk
+            Deep_Inline size_t NumBlocks() const;
+
+            // Returns the `Lanes` values of `field` of `block`
+            Deep_Inline Field* GetLane(size_t block, size_t field) const;
+
+            // Returns `field` of the entity at `index`
+            Deep_Inline Field& Get(size_t index, size_t field) const;
+
+#ifdef DEEP_USE_AVX2
+            // NOTE(randomuserhi): Only available for 8 lanes of float.
+            Deep_Inline __m256 Load(size_t block, size_t field) const;
+            Deep_Inline void Store(size_t block, size_t field, __m256 value) const;
+#endif
+
+        private:
+            uint8* const data;
+
+            // Number of fields per component
+            const size_t numFields;
+
+            // Number of entities in the chunk
+            const size_t size;
         };
 
         class Archetype final : NonCopyable {
             friend class ECDB;
+            friend class ECDBLink;
+
+            template<typename... Ts>
+            friend class View;
 
         public:
             using Chunk = uint8;
@@ -131,8 +368,50 @@ namespace Deep {
             struct ComponentOffset {
                 size_t offset;
                 size_t size;
+
+                // Index of the column within the chunk, used to lookup its change version
+                size_t column;
+
+                // Offset of the enabled bitmask of the column within the chunk, 0 if the component is not enableable
+                // NOTE(randomuserhi): 0 is never a valid bitmask offset as the chunk starts with the Metadata array.
+                size_t mask;
+
+                // Layout of laned components, `lanes` is 0 if the column is an array of whole components
+                size_t fieldSize;
+                size_t lanes;
+            };
+
+            // A single component column copied when an entity moves between archetypes
+            struct ColumnCopy {
+                size_t srcOffset;
+                size_t dstOffset;
+                size_t size;
+
+                // Offsets of the enabled bitmasks, 0 if the component is not enableable
+                size_t srcMask;
+                size_t dstMask;
+
+                // Layout of laned components (the same in both archetypes)
+                size_t fieldSize;
+                size_t lanes;
             };
 
+            // Flat list of the columns copied when moving an entity from a given archetype into this archetype
+            using TransitionPlan = std::vector<ColumnCopy>;
+
+            // Function executed per chunk: (archetype of chunk, chunk, number of entities in chunk, resolved component
+            // offsets)
+            using ChunkFunction =
+                std::function<void(const Archetype* archetype, Chunk* chunk, size_t size, const ComponentOffset* offsets)>;
+
+            // Filter executed per chunk prior processing it: (archetype of chunk, chunk). Returns false to skip the
+            // chunk without touching its columns (e.g by testing a chunk component).
+            using ChunkFilter = std::function<bool(const Archetype* archetype, Chunk* chunk)>;
+
+            // Function executed per component column of a contiguous run of entities:
+            // (index of component in `description.layout`, pointer to the first element, number of elements)
+            using ColumnFunction = std::function<void(size_t column, void* data, size_t count)>;
+
         public:
             explicit Deep_Inline Archetype(ECDB* database);
             Archetype(ECDB* database, ArchetypeDesc&& description);
@@ -148,23 +427,128 @@ namespace Deep {
 
             static Deep_Inline void* GetCompList(Chunk* chunk, ComponentOffset offset);
 
+            // NOTE(randomuserhi): If `T` is not const, the column is marked as changed.
             template<typename T>
-            static Deep_Inline T* GetCompList(Chunk* chunk, ComponentOffset offset);
+            Deep_Inline T* GetCompList(Chunk* chunk, ComponentOffset offset) const;
 
             Deep_Inline void* GetComponent(EntityPtr* entity, ComponentOffset offset) const;
 
             Deep_Inline void* GetComponent(EntityPtr* entity, ComponentId component) const;
 
+            // NOTE(randomuserhi): If `T` is not const, the column is marked as changed.
             template<typename T>
             Deep_Inline T& GetComponent(EntityPtr* entity, ComponentId component) const;
 
             template<typename T>
             Deep_Inline T& GetComponent(EntityPtr* entity, ComponentOffset offset) const;
 
+            // Returns the column of a laned component in `chunk`, where `size` is the number of entities in `chunk`
+            // NOTE(randomuserhi): If `Field` is not const, the column is marked as changed.
+            template<typename Field, size_t Lanes>
+            Deep_Inline LaneColumn<Field, Lanes> GetLaneColumn(Chunk* chunk, ComponentOffset offset, size_t size) const;
+
+            // Copies the component of `entity` into `woValue`. Unlike `GetComponent`, laned components are supported.
+            Deep_Inline void ReadComponent(EntityPtr* entity, ComponentOffset offset, void* woValue) const;
+
+            template<typename T>
+            Deep_Inline T ReadComponent(EntityPtr* entity, ComponentId component) const;
+
+            // Copies `value` into the component of `entity` and marks its column as changed. Unlike `GetComponent`,
+            // laned components are supported.
+            Deep_Inline void WriteComponent(EntityPtr* entity, ComponentOffset offset, const void* value) const;
+
+            template<typename T>
+            Deep_Inline void WriteComponent(EntityPtr* entity, ComponentId component, const T& value) const;
+
+            // Returns the value of a shared component, which is shared by all entities of this archetype
+            Deep_Inline const void* GetSharedComponent(ComponentId component) const;
+
+            template<typename T>
+            Deep_Inline const T& GetSharedComponent(ComponentId component) const;
+
+            // Returns the value of the chunk component `component` of `chunk` (see
+            // `ECRegistry::RegisterChunkComponent`)
+            //
+            // NOTE(randomuserhi): Chunk components are not covered by change versions, but are part of forks and
+            //                     snapshots. The untyped overload (and the typed overload if `T` is not const)
+            //                     preserves the chunk for forks that share it, so read only access should use a const
+            //                     `T`.
+            Deep_Inline void* GetChunkComponent(Chunk* chunk, ComponentId component) const;
+
+            template<typename T>
+            Deep_Inline T& GetChunkComponent(Chunk* chunk, ComponentId component) const;
+
+            // Returns the version of the database at which the column of `offset` was last written to in `chunk`
+            Deep_Inline uint64 GetChangeVersion(Chunk* chunk, ComponentOffset offset) const;
+
+            // Marks the column of `offset` in `chunk` as written to at the current version of the database
+            //
+            // NOTE(randomuserhi): Writes through the untyped `GetCompList` / `GetComponent` must call this prior writing,
+            //                     such that the chunk is preserved for forks that share it.
+            Deep_Inline void MarkChanged(Chunk* chunk, ComponentOffset offset) const;
+
+            // Returns the enabled bitmask of the column of `offset` in `chunk` (bit i is set if the component of the i-th
+            // entity is enabled), nullptr if the component is not enableable
+            static Deep_Inline const uint64* GetEnabledMask(Chunk* chunk, ComponentOffset offset);
+
+            // NOTE(randomuserhi): Components that are not enableable are always enabled.
+            Deep_Inline bool IsEnabled(EntityPtr* entity, ComponentOffset offset) const;
+
+            Deep_Inline bool IsEnabled(EntityPtr* entity, ComponentId component) const;
+
+            // Enables / disables an enableable component of `entity`. Only a single bit is flipped, the entity is not
+            // moved.
+            Deep_Inline void SetEnabled(EntityPtr* entity, ComponentOffset offset, bool enabled) const;
+
+            Deep_Inline void SetEnabled(EntityPtr* entity, ComponentId component, bool enabled) const;
+
+            // Executes `function(index)` for each of the first `size` entities of `chunk` that have all enableable
+            // components of `offsets` enabled (components that are not enableable are ignored). The bitmasks are
+            // combined 64 entities at a time, skipping 64 disabled entities with a single test.
+            template<typename Function>
+            static Deep_Inline void ForEachEnabled(Chunk* chunk, size_t size, const ComponentOffset* offsets,
+                                                   size_t numOffsets, Function&& function);
+
             ECDB::Entt Entity();
 
+            // Creates `count` entities directly inside of this archetype, filling whole chunks at a time.
+            // If provided, `init` is executed per column for each run of created entities within a chunk, otherwise
+            // component data is left uninitialized.
+            std::vector<ECDB::Entt> CreateEntities(size_t count, const ColumnFunction& init = nullptr);
+
+            // Creates `count` entities directly inside of this archetype, filling whole chunks at a time.
+            // `prototype` holds a pointer to a value per component in `description.layout` which is copied into every
+            // created entity. A nullptr value leaves the component uninitialized.
+            std::vector<ECDB::Entt> CreateEntities(size_t count, const void* const* prototype);
+
             void Move(EntityPtr* entity);
 
+            // Moves `entity` into this archetype using a plan precomputed by `GetTransitionPlan` for the archetype the
+            // entity is currently in.
+            void Move(EntityPtr* entity, const TransitionPlan& plan);
+
+            // Computes the columns to copy when moving an entity from `source` into this archetype
+            TransitionPlan GetTransitionPlan(const Archetype& source) const;
+
+            // Moves all entities from `source` into this archetype. If both archetypes share the same chunk layout, whole
+            // chunks are traded instead of moving entities one by one.
+            void Move(Archetype& source);
+
+            // Returns true if chunks of `other` have the same layout as chunks of this archetype
+            // (e.g archetypes that only differ by tags)
+            bool SharesLayout(const Archetype& other) const;
+
+            // Relinks all chunks of `source` into this archetype, only the archetype of the entities inside is updated
+            // and no component data is copied. Both archetypes must share the same layout.
+            //
+            // NOTE(randomuserhi): If the tail chunk of this archetype is partially filled, the entities in the partially
+            //                     filled tail chunk of `source` are moved individually (atmost 1 chunk of entities).
+            void TradeChunks(Archetype& source);
+
+            // Swaps the positions (and component data) of two entities within this archetype, such that the order of
+            // entities can be rearranged without moving them between archetypes
+            void Swap(EntityPtr* a, EntityPtr* b);
+
             Deep_Inline void Remove(EntityPtr* entity);
 
             Deep_Inline size_t size() const;
@@ -176,18 +560,103 @@ namespace Deep {
 
             Deep_Inline Chunk* GetNextChunk(Chunk* chunk) const;
 
+            // Splits the chunk list into `numJobs` evenly sized batches and executes `function` on each chunk using the
+            // job system. Returns once all chunks have been processed.
+            //
+            // `components` are resolved once into the `ComponentOffset`s passed to `function` (in the same order as
+            // `components`).
+            void ForEachChunkParallel(JobSystem* jobSystem, const ComponentId* components, size_t numComponents,
+                                      const ChunkFunction& function, size_t numJobs) const;
+
         private:
+            // Edge of the archetype graph, holding the plan for moving an entity from this archetype to `archetype`
+            struct Edge {
+                Archetype* archetype;
+                TransitionPlan plan;
+            };
+
+            // Appends the chunks of this archetype to `rwChunks`, each referencing `offsets`. If `numChanged` is non
+            // zero, chunks are skipped unless atleast 1 of the `changed` columns was written to after `sinceVersion`.
+            // Chunks rejected by `filter` (if provided) are skipped.
+            void GatherChunks(std::vector<ParallelChunk>& rwChunks, const ComponentOffset* offsets,
+                              const ComponentOffset* changed = nullptr, size_t numChanged = 0, uint64 sinceVersion = 0,
+                              const ChunkFilter& filter = nullptr) const;
+
+            // Returns the change versions of the columns of `chunk`
+            // NOTE(randomuserhi): Change versions are stored right after the pointer to the next chunk.
+            Deep_Inline uint64* GetVersions(Chunk* chunk) const;
+
+            // Marks all columns of `chunk` as written to at the current version of the database (used on structural
+            // changes)
+            void MarkChunkChanged(Chunk* chunk) const;
+
+            // Returns the fork epoch of the database at which `chunk` was last preserved
+            // NOTE(randomuserhi): The epoch is stored right after the pointer to the next chunk.
+            Deep_Inline std::atomic<uint64>& GetEpoch(Chunk* chunk) const;
+
+            // Offset of the chunk components within a chunk (right after the change versions). The chunk components
+            // span up to `allocationSize`.
+            Deep_Inline size_t GetChunkComponentsOffset() const;
+
+            // Must be called prior writing to `chunk`. If `chunk` is shared with forks, its contents are copied for the
+            // forks prior the write. Safe to call from multiple threads (e.g within `ForEachChunkParallel` or systems).
+            Deep_Inline void Preserve(Chunk* chunk) const;
+
             Deep_Inline void SetNextChunk(Chunk* chunk, Chunk* next);
 
+            // Copies the component at `srcIndex` of the column `src` to `dstIndex` of the column `dst`. A `lanes` of 0
+            // refers to an array of whole components, such that a value can be copied in / out of a laned column.
+            static Deep_Inline void CopyComponent(uint8* dst, size_t dstIndex, size_t dstLanes, const uint8* src,
+                                                  size_t srcIndex, size_t srcLanes, size_t size, size_t fieldSize);
+
+            // Number of bytes occupied by a column of `component` holding `count` entities
+            static Deep_Inline size_t GetColumnSize(const ComponentDesc& component, size_t count);
+
+            // Returns the offset of `field` of the entity at `index` relative to the start of its column
+            static Deep_Inline size_t GetFieldOffset(size_t index, size_t field, size_t size, size_t fieldSize,
+                                                     size_t lanes);
+
+            // Sets the bit of the entity at `index` in the bitmask at `mask`
+            static Deep_Inline void SetEnabledBit(Chunk* chunk, size_t mask, size_t index, bool enabled);
+
+            static Deep_Inline bool GetEnabledBit(Chunk* chunk, size_t mask, size_t index);
+
+            // Swaps the component at `aIndex` of the column `a` with the component at `bIndex` of the column `b`, both
+            // columns must have the same layout
+            static Deep_Inline void SwapComponent(uint8* a, size_t aIndex, uint8* b, size_t bIndex, size_t lanes,
+                                                  size_t size, size_t fieldSize);
+
             void Deallocate(EntityPtr* entity);
 
+            // Releases all chunks to the chunk pool without updating the entities inside of them
+            void ReleaseChunks();
+
+            // Appends a new empty chunk to the chunk list, reusing a pooled chunk if available
+            Chunk* AllocateChunk();
+
+            // Returns `chunk` to the chunk pool of the database
+            void FreeChunk(Chunk* chunk);
+
+            // Places `entities` (which do not belong to an archetype) into this archetype in bulk
+            void Emplace(EntityPtr* const* entities, size_t count, const ColumnFunction& init);
+
             ECDB* const database;
 
+            // Order in which the archetype was created within the database. Unlike the address of the archetype, it
+            // is the same between runs, so it is used to order archetypes deterministically (e.g on playback).
+            size_t id = 0;
+
             // NOTE(randomuserhi): The same as the size of the data-region of the chunk
             //                     The pointer to the next chunk appears right after the data-region
-            //                     and the data region is aligned properly.
+            //                     and the data region is aligned properly. The fork epoch of the chunk followed by the
+            //                     change version of each column are stored after the pointer to the next chunk.
+            //                     The enabled bitmasks of enableable components are stored in the data-region right after
+            //                     the Metadata array. Chunk components are stored after the change versions.
             const size_t chunkSize;
 
+            // Number of bytes allocated per chunk (data-region followed by the chunk header)
+            size_t allocationSize;
+
             size_t entitiesPerChunk = chunkSize / sizeof(Metadata);
 
             // Number of entities occupying this archetype
@@ -195,38 +664,334 @@ namespace Deep {
 
             size_t firstFreeItemInNewChunk = 0;
 
-            Chunk* firstFree = nullptr;
+            // NOTE(randomuserhi): Shared with all archetypes whose chunks have the same allocation size. Obtained on
+            //                     first allocation.
+            SlabAllocator* allocator = nullptr;
 
             // NOTE(randomuserhi): The singly linked list is organised backwards (from tail -> head)
             Chunk* tail = nullptr;
 
-            // Instead of the above, finding the offset of a component within a chunk is done using the 2 buckets
-            // `ids` and `offsets`. Each item in `ids` and `offsets` correspond to each other so `offsets[0]` is the offset
-            // for ComponentId `ids[0]`.
+            // Offset of each component within a chunk, looked up by ComponentId with a single array read (see
+            // `ComponentMap`).
             //
-            // When looking up the offset for a given ComponentId, (ComponentId % numComponentsInArchetype) is used to index
-            // the `ids` bucket. A linear probe is then used to resolve hash conflicts (iterating `ids` until a match is
-            // found). The index of the match is then used to lookup the offset from the `offsets` bucket.
+            // NOTE(randomuserhi): Does not include tags since they dont contribute any data.
+            ComponentMap<ComponentOffset> offsets;
+
+            // Offset of each component in `description.layout` (in the same order), used when iterating all components
+            // without looking up `offsets`. The index of a column is also the index of its change version.
+            std::vector<ComponentOffset> columns;
+
+            // Offset of the enabled bitmask of each enableable component
+            std::vector<size_t> masks;
+
+            // Offset of each chunk component relative to the start of the chunk
+            ComponentMap<size_t> chunkOffsets;
+
+            // Edges of the archetype graph, reached by adding / removing a component
             //
-            // This is a more cache efficient `std::unordered_map<ComponentId, size_t>` specialized for the constraints of:
-            // - Fixed number of components in an archetype
-            // - ComponentIds are numbers
-            // - Number of components is low
+            // NOTE(randomuserhi): Edges are created lazily when traversed. `GetAddEdge` / `GetRemoveEdge` look up an
+            //                     existing archetype prior creating one, so all paths to an archetype share it.
+            ComponentMap<Edge> addMap;
+            ComponentMap<Edge> removeMap;
+
+            // Archetypes whose remove edge of a shared component leads to this archetype, as (archetype, component)
             //
-            // NOTE(randomuserhi): Does not include tags since they dont contribute any data.
-            // NOTE(randomuserhi): `ids` holds ComponentId + 1 as the value 0 is used to denote an empty bucket slot
-            //                     during initialization.
-            // TODO(randomuserhi): Use a single allocated block (where ids and offsets are adjacent) instead of 2 vectors
-            std::vector<ComponentId> ids;
-            std::vector<ComponentOffset> offsets;
-
-            std::unordered_map<ComponentId, Archetype*> addMap;
-
-            // TODO(randomuserhi): Needs to somehow associate to the same archetypes as the addMap
-            //                     (2 different paths can result in the same archetype now)
-            //                     Probably just iterate database->archetypes to find matching type
-            //                     (number of archs is low enough to linear search)
-            std::unordered_map<ComponentId, Archetype*> removeMap;
+            // NOTE(randomuserhi): Adding a shared component has no edge (see `LinkArchetypes`), so these cannot be
+            //                     found through `addMap` when the archetype is retired.
+            std::vector<std::pair<Archetype*, ComponentId>> sharedRemoveEdges;
+        };
+
+    public:
+        // A query caches the list of archetypes that match its description. The cache is updated incrementally by the
+        // database whenever a new archetype is created, so obtaining the matching archetypes never rescans the database.
+        //
+        // NOTE(randomuserhi): Queries are owned by the database and live as long as it does.
+        class Query final : NonCopyable {
+            friend class ECDB;
+
+            template<typename... Ts>
+            friend class View;
+
+        public:
+            Query(ECDB* database, QueryDesc&& description);
+
+            // Archetypes that match this query
+            Deep_Inline const std::vector<Archetype*>& archetypes() const;
+
+            // Total number of entities across all matching archetypes
+            size_t size() const;
+
+            // Splits the chunks of all matching archetypes into `numJobs` evenly sized batches and executes `function`
+            // on each chunk using the job system. Returns once all chunks have been processed.
+            //
+            // `components` are resolved once per archetype into the `ComponentOffset`s passed to `function` (in the
+            // same order as `components`). All `components` must be part of the query's `With` set.
+            //
+            // If the query has `Changed` components, chunks are skipped unless atleast 1 of them was written to after
+            // `sinceVersion`. A `sinceVersion` of 0 includes all chunks. If provided, `filter` is executed per chunk
+            // (serially, prior dispatching) and chunks it rejects are skipped.
+            void ForEachChunkParallel(JobSystem* jobSystem, const ComponentId* components, size_t numComponents,
+                                      const Archetype::ChunkFunction& function, size_t numJobs,
+                                      uint64 sinceVersion = 0, const Archetype::ChunkFilter& filter = nullptr) const;
+
+            // Executes `function` on each chunk of all matching archetypes, see `ForEachChunkParallel`
+            void ForEachChunk(const ComponentId* components, size_t numComponents, const Archetype::ChunkFunction& function,
+                              uint64 sinceVersion = 0, const Archetype::ChunkFilter& filter = nullptr) const;
+
+            // Executes `function(Archetype&, Entt, T&)` on each entity matching this query that has the sparse
+            // component `component`.
+            //
+            // NOTE(randomuserhi): The sparse set is iterated (rather than the chunks of the query), so the cost
+            //                     scales with the number of entities that have the sparse component. `Changed`
+            //                     filters are not applied.
+            // NOTE(randomuserhi): `function` must not add / remove `component`, use a CommandBuffer instead.
+            template<typename T, typename Function>
+            Deep_Inline void Join(ComponentId component, Function&& function) const;
+
+            // Describes the query (with / without / any / changed)
+            const QueryDesc description;
+
+        private:
+            // Caches the archetype if it matches this query
+            Deep_Inline void Register(Archetype* archetype);
+
+            // Appends the chunks of all matching archetypes to `rwChunks`, resolving `components` into `rwOffsets`
+            void GatherChunks(std::vector<ParallelChunk>& rwChunks, std::vector<Archetype::ComponentOffset>& rwOffsets,
+                              const ComponentId* components, size_t numComponents, uint64 sinceVersion,
+                              const Archetype::ChunkFilter& filter) const;
+
+            ECDB* const database;
+
+            std::vector<Archetype*> matches;
+        };
+
+    public:
+        // An archetype with a default value per component, from which entities are instantiated in bulk. The default
+        // values are replicated into freshly reserved chunk slots a column at a time (see `Archetype::CreateEntities`)
+        // rather than building each entity a component at a time, which traverses an archetype graph edge and moves the
+        // entity per component.
+        //
+        // NOTE(randomuserhi): Prefabs are owned by the database and live as long as it does. The archetype of a prefab
+        //                     is never retired by `Compact`.
+        class Prefab final : NonCopyable {
+            friend class ECDB;
+
+        public:
+            explicit Prefab(Archetype* archetype);
+
+            // Sets the default value of `component`, components without a default value are zero initialized
+            Prefab& SetComponent(ComponentId component, const void* value);
+
+            template<typename T>
+            Deep_Inline Prefab& SetComponent(ComponentId component, const T& value);
+
+            // Returns the default value of `component`
+            Deep_Inline const void* GetComponent(ComponentId component) const;
+
+            template<typename T>
+            Deep_Inline T GetComponent(ComponentId component) const;
+
+            // Creates `count` entities holding the default values of this prefab
+            Deep_Inline std::vector<ECDB::Entt> Instantiate(size_t count) const;
+
+            Deep_Inline ECDB::Entt Instantiate() const;
+
+            Archetype* const archetype;
+
+        private:
+            // Default values of the components in `archetype->description.layout`, stored back to back
+            std::vector<uint8> data;
+
+            // Offset of the default value of each component in `data` (in the same order as the layout)
+            std::vector<size_t> offsets;
+
+            // Pointer to the default value of each component in `data` (in the same order as the layout)
+            std::vector<const void*> prototype;
+        };
+
+    public:
+        // Typed view over the chunks of all archetypes matching a query. Component offsets are resolved once per
+        // archetype and each chunk is passed to a template callback as `(count, T1*, T2*, ...)`, such that the loop
+        // over the entities of a chunk is inlined into the chunk loop and can be vectorized by the compiler (no
+        // std::function call or size lookup per chunk).
+        //
+        // NOTE(randomuserhi): If `T` is not const, the column is marked as changed. Laned components are unsupported
+        //                     (see `Archetype::GetLaneColumn`) and disabled enableable components are not skipped.
+        template<typename... Ts>
+        class View {
+        public:
+            // `components` holds the ComponentId of each `T`, all of which must be part of the query's `With` set
+            Deep_Inline View(const Query& query, const std::array<ComponentId, sizeof...(Ts)>& components);
+
+            // Executes `function(count, T1* Deep_Restrict, T2* Deep_Restrict, ...)` on each chunk. The columns of a
+            // chunk never alias, so the callback can declare its pointers as `Deep_Restrict`.
+            //
+            // If the query has `Changed` components, chunks are skipped unless atleast 1 of them was written to after
+            // `sinceVersion`. A `sinceVersion` of 0 includes all chunks. Chunks rejected by `filter` (if provided) are
+            // skipped.
+            template<typename Function>
+            Deep_Inline void ForEachChunk(Function&& function, uint64 sinceVersion = 0,
+                                          const Archetype::ChunkFilter& filter = nullptr) const;
+
+            // Executes `function(T1&, T2&, ...)` on each entity, see `ForEachChunk`
+            template<typename Function>
+            Deep_Inline void ForEach(Function&& function, uint64 sinceVersion = 0,
+                                     const Archetype::ChunkFilter& filter = nullptr) const;
+
+        private:
+            template<typename Function, size_t... Is>
+            Deep_Inline void ForEachChunk(Function&& function, uint64 sinceVersion,
+                                          const Archetype::ChunkFilter& filter, std::index_sequence<Is...>) const;
+
+            const Query& query;
+
+            const std::array<ComponentId, sizeof...(Ts)> components;
+        };
+
+    public:
+        // Records structural changes (create / destroy / add / remove) and component writes without touching the
+        // database. The recorded commands are applied later by `ECDB::Playback`.
+        //
+        // Recording does not access the database, so each thread can safely record into its own command buffer while
+        // the database is being read by other threads.
+        //
+        // NOTE(randomuserhi): A single command buffer is not thread safe, use one command buffer per thread.
+        class CommandBuffer final : NonCopyable {
+            friend class ECDB;
+
+        public:
+            // References an entity within a command buffer. This is either an existing entity or an entity that will be
+            // created by the command buffer on playback.
+            //
+            // NOTE(randomuserhi): A created entity can only be referenced by the command buffer that created it.
+            struct DeferredEntt {
+                friend class ECDB;
+                friend class CommandBuffer;
+
+            public:
+                Deep_Inline DeferredEntt(EntityPtr* entity);
+                Deep_Inline DeferredEntt(const ECDB::Entt& entity);
+
+            private:
+                explicit Deep_Inline DeferredEntt(size_t index);
+
+                // Existing entity, nullptr if the entity is created by the command buffer
+                EntityPtr* entity;
+
+                // Index of the created entity within the command buffer
+                size_t index;
+            };
+
+        public:
+            // NOTE(randomuserhi): Command buffers register with the database, so they must be destroyed prior it.
+            explicit Deep_Inline CommandBuffer(ECDB* database);
+            ~CommandBuffer();
+
+            // Creates an entity inside of the given archetype (or the root archetype if nullptr)
+            DeferredEntt Entity(Archetype* archetype = nullptr);
+
+            void Destroy(DeferredEntt entity);
+
+            void AddComponent(DeferredEntt entity, ComponentId component);
+
+            void RemoveComponent(DeferredEntt entity, ComponentId component);
+
+            // Copies `data` into the command buffer, the value is written to the entity on playback.
+            // `data` must point to a value of the size of the component.
+            void SetComponent(DeferredEntt entity, ComponentId component, const void* data);
+
+            template<typename T>
+            Deep_Inline void SetComponent(DeferredEntt entity, ComponentId component, const T& value);
+
+            // Returns true if there are no recorded commands
+            Deep_Inline bool IsEmpty() const;
+
+            // Discards all recorded commands
+            Deep_Inline void Clear();
+
+        private:
+            enum class CommandType : uint8 { Create, Destroy, AddComponent, RemoveComponent, SetComponent };
+
+            struct Command {
+                CommandType type;
+
+                DeferredEntt entity;
+
+                // Archetype to create the entity in (Create)
+                Archetype* archetype;
+
+                // Component to add / remove / set (AddComponent, RemoveComponent, SetComponent)
+                ComponentId component;
+
+                // Offset of the value within `data` (SetComponent)
+                size_t dataOffset;
+            };
+
+            ECDB* const database;
+
+            std::vector<Command> commands;
+
+            // Values recorded by `SetComponent`
+            std::vector<uint8> data;
+
+            // Number of entities created by this command buffer
+            size_t numCreated = 0;
+        };
+
+    public:
+        // A logical copy of all entities of the database at the time it was created by `ECDB::Fork`.
+        //
+        // Chunks are shared between the database and its forks until the database next writes to them. Prior the write,
+        // the contents of the chunk are copied once and shared by all forks that reference the chunk (chunk granular
+        // copy-on-write), so creating a fork copies no component data.
+        //
+        // NOTE(randomuserhi): Forks are owned by the database and are released with `ECDB::Release`.
+        class ForkState final : NonCopyable {
+            friend class ECDB;
+
+        private:
+            // Copy of the contents of a chunk prior it being written to
+            struct ChunkCopy {
+                explicit ChunkCopy(size_t size);
+                ~ChunkCopy();
+
+                Deep_Inline void Acquire();
+                Deep_Inline void Release();
+
+                uint8* data;
+                size_t referenceCount = 0;
+            };
+
+            struct ChunkRef {
+                // Chunk of the database the contents were taken from
+                Archetype::Chunk* chunk;
+
+                // Copy of the contents, nullptr whilst `chunk` still holds the contents of the fork
+                Ref<ChunkCopy> copy;
+            };
+
+            struct ArchetypeState {
+                Archetype* archetype;
+
+                size_t numEntities;
+                size_t firstFreeItemInNewChunk;
+
+                // NOTE(randomuserhi): Ordered from tail -> head like the chunk list of the archetype.
+                std::vector<ChunkRef> chunks;
+            };
+
+            explicit Deep_Inline ForkState(ECDB* database);
+
+            ECDB* const database;
+
+            // State of each archetype that contained entities when the fork was created
+            std::vector<ArchetypeState> archetypes;
+
+            // Generation of each slot of the entity lookup table when the fork was created
+            std::vector<uint32> generations;
+
+            // Contents of each sparse set when the fork was created
+            std::vector<std::pair<ComponentId, SparseSet>> sparseSets;
         };
 
     private:
@@ -236,56 +1001,327 @@ namespace Deep {
             size_t index;
         };
 
-        struct EntityPage {
-            // TODO(randomuserhi): For concurrent access, each Storage in entityLookup should be aligned to
-            //                     DEEP_CACHE_LINE_SIZE
+        // A chunk to be processed by `ForEachChunkParallel`
+        struct ParallelChunk {
+            const Archetype* archetype;
+            Archetype::Chunk* chunk;
+            size_t size;
+            const Archetype::ComponentOffset* offsets;
+        };
 
-            struct Storage {
-                EntityPtr ptr;
-                Storage* next;
-            };
+        // Dispatches `chunks` across `numJobs` jobs and waits for them to complete
+        static void DispatchParallel(JobSystem* jobSystem, const std::vector<ParallelChunk>& chunks,
+                                     const Archetype::ChunkFunction& function, size_t numJobs);
 
-            static const size_t pageSize = 127;
+        // Slot of the entity lookup table
+        //
+        // TODO(randomuserhi): For concurrent access, each slot should be aligned to DEEP_CACHE_LINE_SIZE
+        struct EntitySlot {
+            EntityPtr ptr;
 
-            // NOTE(randomuserhi): These should remain uninitialized until allocated
-            Storage entityLookup[pageSize];
+            // Index of the slot within the lookup table
+            uint32 index;
 
-            EntityPage* next = nullptr;
+            // Incremented when the slot is freed, invalidating handles to the previous entity
+            uint32 generation;
 
-        private:
-            char _padding[sizeof(Storage) - sizeof(EntityPage*)];
+            // Index of the next free slot, `usedSlot` if the slot holds an entity
+            uint32 nextFree;
         };
 
+        static const uint32 noSlot = 0xFFFFFFFF;
+        static const uint32 usedSlot = 0xFFFFFFFE;
+
+        // NOTE(randomuserhi): The lookup table grows in fixed size blocks such that slots never move. This keeps
+        //                     `EntityPtr*` (held by `Entt` and chunk metadata) stable whilst the table stays indexable.
+        static const size_t entityBlockSize = 1024;
+
     public:
-        explicit Deep_Inline ECDB(ECRegistry* registry, size_t chunkSize = 16384);
+        // NOTE(randomuserhi): If `useHugePages` is set, chunks are allocated from slabs backed by huge pages where the
+        //                     platform supports it.
+        explicit Deep_Inline ECDB(ECRegistry* registry, size_t chunkSize = 16384, bool useHugePages = false);
         ~ECDB();
 
         ECDB::Entt Entity();
 
+        // Current version of the database, writes to component data are stamped with this version
+        Deep_Inline uint64 GetVersion() const;
+
+        // Advances the version of the database and returns the new version. Should be called atleast once per tick
+        // (or before each system that filters by changes runs) such that writes made after a system has run are not
+        // stamped with the version the system last ran at.
+        Deep_Inline uint64 Tick();
+
+        // Enables / disables recording of the per-frame event logs (disabled by default). Whilst enabled, creating /
+        // destroying entities and moving entities between archetypes append to the logs as a side effect, such that
+        // systems (e.g replication or spatial indices) can do work proportional to churn rather than world size.
+        //
+        // An entity appears once per event, so an entity created, moved and destroyed within a frame appears in all
+        // three logs. Bulk operations (e.g `CreateEntities`, `DestroyAll`, trading chunks) record an event per entity.
+        // Entities placed directly inside of an archetype on creation only record a created event.
+        //
+        // NOTE(randomuserhi): The logs grow until `ClearEvents` is called, which should happen once per frame after all
+        //                     consumers have run. `Restore` clears the logs as they no longer describe the state of
+        //                     the database. Archetypes referenced by move events may be retired by `Compact`.
+        Deep_Inline void SetEventRecording(bool enabled);
+
+        // Handles of entities created since the logs were last cleared, in order of creation
+        Deep_Inline const std::vector<EntityHandle>& GetCreatedEvents() const;
+
+        // Handles of entities destroyed since the logs were last cleared (the handles are no longer valid)
+        Deep_Inline const std::vector<EntityHandle>& GetDestroyedEvents() const;
+
+        // Entities that changed archetype since the logs were last cleared, in the order they were moved
+        Deep_Inline const std::vector<MoveEvent>& GetMovedEvents() const;
+
+        // Clears the event logs, keeping their memory for the next frame
+        Deep_Inline void ClearEvents();
+
+        // Removes the entity from its archetype and releases its lookup slot, invalidating any handles to it
+        void Destroy(EntityPtr* entity);
+
+        Deep_Inline EntityHandle GetHandle(EntityPtr* entity) const;
+
+        // Returns true if `handle` refers to an entity that has not been destroyed
+        Deep_Inline bool IsValid(EntityHandle handle) const;
+
+        // Returns the entity of `handle`, which must be valid
+        Deep_Inline Entt GetEntity(EntityHandle handle);
+
+        // Destroys all entities in `archetype`. Entire chunks are released to the chunk pool rather than
+        // removing each entity individually.
+        void DestroyAll(Archetype& archetype);
+
+        // Destroys all entities matching `query`
+        void DestroyAll(const Query& query);
+
+        // Returns the memory of pooled chunks back to the OS where possible (slabs that contain no chunks in use).
+        // Returns the number of bytes released.
+        size_t Trim();
+
+        // Incrementally reclaims memory held by the database, stopping once `budget` has elapsed:
+        // 1. Archetypes without entities are retired, removing them from the archetype graph and all queries
+        // 2. Pooled chunks are returned back to the OS (see `Trim`)
+        //
+        // Returns true once there is nothing left to reclaim, otherwise `Compact` should be called again (e.g the next
+        // frame) to continue.
+        //
+        // NOTE(randomuserhi): References to retired archetypes are invalidated, they need to be obtained again through
+        //                     `GetArchetype`. The root archetype and archetypes referenced by a fork, prefab, link
+        //                     (destination archetype) or by a pending command of a command buffer are never retired.
+        bool Compact(std::chrono::microseconds budget);
+
         void AddComponent(EntityPtr* entity, ComponentId component);
 
         void RemoveComponent(EntityPtr* entity, ComponentId component);
 
+        // Sets the value of a shared component, moving the entity to the archetype of the new value. The shared component
+        // is added if the entity does not have it. Shared components are removed with `RemoveComponent`.
+        void SetSharedComponent(EntityPtr* entity, ComponentId component, const void* value);
+
+        template<typename T>
+        Deep_Inline void SetSharedComponent(EntityPtr* entity, ComponentId component, const T& value);
+
+        // Enables / disables an enableable component without moving the entity
+        Deep_Inline void SetEnabled(EntityPtr* entity, ComponentId component, bool enabled);
+
+        Deep_Inline bool IsEnabled(EntityPtr* entity, ComponentId component) const;
+
+        // Returns the value of a sparse component, nullptr if the entity does not have the component.
+        //
+        // NOTE(randomuserhi): Adding / removing the sparse component of any entity invalidates the returned pointer.
+        Deep_Inline void* GetSparseComponent(EntityPtr* entity, ComponentId component) const;
+
+        template<typename T>
+        Deep_Inline T* GetSparseComponent(EntityPtr* entity, ComponentId component) const;
+
+        // Sets the value of a shared component for all entities in `archetype`. Chunks are traded rather than copying
+        // each entity.
+        void SetSharedComponent(Archetype& archetype, ComponentId component, const void* value);
+
+        // Adds / removes `component` from all entities in `archetype`. If the component is a tag, chunks are traded
+        // between archetypes rather than copying each entity.
+        void AddComponent(Archetype& archetype, ComponentId component);
+
+        void RemoveComponent(Archetype& archetype, ComponentId component);
+
         Deep_Inline ECDB::Archetype& GetRootArchetype();
 
         ECDB::Archetype& GetArchetype(ComponentId* components, size_t numComponents);
 
+        // Returns the archetype matching `description` (including the values of shared components), creating it if it
+        // does not exist
+        ECDB::Archetype& GetArchetype(const ArchetypeDesc& description);
+
+        // If a query with the same description already exists, it is returned instead of creating a new one
+        ECDB::Query& GetQuery(const QueryDesc& description);
+
+        // Creates a prefab of the archetype matching `description`, see `Prefab`
+        ECDB::Prefab& CreatePrefab(const ArchetypeDesc& description);
+
+        // Applies the commands recorded in the given command buffers and clears them.
+        //
+        // Commands are applied in batches rather than in the order they were recorded:
+        // 1. Entities are created, grouped by archetype
+        // 2. Entities changing archetype are moved, grouped by source -> destination archetype
+        // 3. Entities are destroyed, grouped by archetype
+        // 4. Recorded component values are written in the order they were recorded
+        //
+        // The net result per entity is the same as applying its commands in order, with the exception that component
+        // values are written after all structural changes. Values for components that the entity no longer has are
+        // discarded. Adding a component the entity already has or removing one it does not have is ignored.
+        void Playback(CommandBuffer* const* buffers, size_t numBuffers);
+        Deep_Inline void Playback(CommandBuffer& buffer);
+
+        // Creates a fork of the current state of all entities, see `ForkState`
+        ForkState* Fork();
+
+        // Restores all entities to the state of `fork`. Entities created after the fork are destroyed, and handles to
+        // entities destroyed after the fork become valid again.
+        //
+        // Chunks that have not been written to since the fork are relinked in place, only chunks that were written to
+        // are copied back.
+        //
+        // NOTE(randomuserhi): Restoring rebuilds the free list of the entity lookup, so entities created after restoring
+        //                     may not reuse the same lookup slots as prior restoring.
+        void Restore(const ForkState* fork);
+
+        // Releases `fork`, freeing the chunk contents only referenced by it
+        void Release(ForkState* fork);
+
+        // Serializes all entities of the database into `woData`.
+        //
+        // The snapshot holds the layout of the registry, the archetype table and the raw bytes of each chunk, where the
+        // pointers to entities in the Metadata array are replaced by the index of the entity within the snapshot. Chunk
+        // bytes are aligned to DEEP_CACHE_LINE_SIZE relative to the start of the snapshot such that the snapshot can be
+        // memory mapped and passed to `LoadSnapshot` as is. The chunk components of each chunk follow the chunk bytes
+        // of their archetype.
+        //
+        // Sparse components are stored after the chunks as (entity index, value) pairs per component.
+        //
+        // NOTE(randomuserhi): The snapshot uses the native endianness and pointer size of the platform.
+        void SaveSnapshot(std::vector<uint8>& woData) const;
+
+        // Loads the entities of a snapshot created by `SaveSnapshot` (e.g from a memory mapped file). Chunks are copied
+        // into the database as a whole and the entities inside are rebuilt in a single pass over each chunk.
+        //
+        // The registry must contain the components the snapshot was saved with (same ids, sizes, alignments and lane
+        // layouts) and the database must have the same chunk size. Archetypes of the snapshot must not contain any
+        // entities prior loading.
+        //
+        // Returns false (without creating any archetypes or loading any entities) if the snapshot is malformed,
+        // incompatible or an archetype of the snapshot already contains entities.
+        bool LoadSnapshot(const void* data, size_t size);
+
     private:
         EntityPtr* AllocateEntity();
 
+        void AllocateEntities(EntityPtr** woEntities, size_t count);
+
+        // Returns the lookup slot of `entity` to the free list
+        void FreeEntity(EntityPtr* entity);
+
+        // Appends a new slot to the lookup table
+        EntitySlot* NewEntitySlot();
+
+        Deep_Inline EntitySlot& GetEntitySlot(uint32 index) const;
+
+        // NOTE(randomuserhi): `ptr` is the first member of EntitySlot, so the entity pointer is also a pointer to its
+        //                     slot.
+        static Deep_Inline EntitySlot* GetEntitySlot(EntityPtr* entity);
+
+        // Appends a move event if event recording is enabled
+        Deep_Inline void RecordMove(EntityPtr* entity, const Archetype* from, const Archetype* to);
+
+        // Returns the sparse set of `component`, creating it if it does not exist
+        SparseSet& GetSparseSet(ComponentId component);
+
+        // Returns nullptr if no entity has had `component` added yet
+        Deep_Inline SparseSet* FindSparseSet(ComponentId component) const;
+
+        // Copies the contents of `chunk` for the forks that still share it and marks it as preserved at the current
+        // fork epoch
+        void PreserveChunk(const Archetype* archetype, Archetype::Chunk* chunk);
+
+        // Returns the chunk pool for chunks of `allocationSize` bytes
+        SlabAllocator* GetChunkAllocator(size_t allocationSize);
+
+        // Adds a newly created archetype to the database and notifies queries of its existence
+        void RegisterArchetype(Archetype* archetype);
+
+        // Removes an archetype without entities from the database, the archetype graph and all queries and deletes it
+        void RetireArchetype(Archetype* archetype);
+
+        // Returns the archetype matching `description`, nullptr if it does not exist
+        Archetype* FindArchetype(const ArchetypeDesc& description) const;
+        Archetype* FindArchetype(const ArchetypeKey& key) const;
+
+        // Traverses the archetype graph to obtain the edge reached by adding / removing `component` from `archetype`.
+        // The archetype (and graph edge) is created if it does not exist.
+        const Archetype::Edge& GetAddEdge(Archetype* archetype, ComponentId component);
+        const Archetype::Edge& GetRemoveEdge(Archetype* archetype, ComponentId component);
+
+        Deep_Inline Archetype* GetAddArchetype(Archetype* archetype, ComponentId component);
+        Deep_Inline Archetype* GetRemoveArchetype(Archetype* archetype, ComponentId component);
+
+        // Creates the graph edges between `archetype` and `other`, where `other` is `archetype` with `component` added
+        static void LinkArchetypes(Archetype* archetype, Archetype* other, ComponentId component);
+
         ECRegistry* const registry;
 
         const size_t chunkSize;
 
-        std::unordered_map<ArchetypeBitField, Archetype*> archetypes;
+        const bool useHugePages;
+
+        // Chunks are pooled across all archetypes. Archetypes with a different number of columns have a different
+        // allocation size (the change versions follow the data-region), hence a pool per allocation size.
+        std::unordered_map<size_t, SlabAllocator*> chunkAllocators;
+
+        uint64 version = 1;
+
+        // Incremented whenever a fork is created, chunks last preserved at an older epoch may be shared with forks
+        uint64 forkEpoch = 0;
+
+        std::vector<ForkState*> forks;
+
+        // References from forks to chunks that still hold the contents of the fork
+        std::unordered_map<Archetype::Chunk*, std::vector<ForkState::ChunkRef*>> pending;
+
+        // Guards `pending` and chunk epochs whilst chunks are preserved from multiple threads
+        std::mutex preserveMutex;
+
+        std::unordered_map<ArchetypeKey, Archetype*> archetypes;
 
         Archetype* rootArchetype;
 
-        size_t firstFreeItemInNewPage = 0;
+        // Id of the next created archetype, see `Archetype::id`
+        size_t nextArchetypeId = 0;
+
+        std::vector<Query*> queries;
+
+        std::vector<Prefab*> prefabs;
+
+        // Command buffers and links recording into / linked to the database, see `Compact`
+        std::vector<CommandBuffer*> commandBuffers;
+        std::vector<ECDBLink*> links;
+
+        // Lookup table of entities, indexed by the index of an EntityHandle
+        std::vector<EntitySlot*> entityBlocks;
+
+        // Number of slots in the lookup table
+        uint32 numEntitySlots = 0;
+
+        // Index of the first free slot, `noSlot` if there are no free slots
+        uint32 firstFree = noSlot;
 
-        EntityPage::Storage* firstFree = nullptr;
+        // Storage of sparse components, keyed by the index of an entity's slot
+        ComponentMap<SparseSet*> sparseSets;
 
-        EntityPage* entityPages = nullptr;
+        // Per-frame event logs, see `SetEventRecording`
+        bool recordEvents = false;
+        std::vector<EntityHandle> createdEvents;
+        std::vector<EntityHandle> destroyedEvents;
+        std::vector<MoveEvent> movedEvents;
     };
 
     using Entt = ECDB::Entt;
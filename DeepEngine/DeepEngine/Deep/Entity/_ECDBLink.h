@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Deep/NonCopyable.h>
+
+#include <utility>
+#include <vector>
+
+namespace Deep {
+    // Pairs the entities matching a query of a source database with entities of a single archetype of a destination
+    // database (e.g gameplay entities with their rigid bodies in a physics database).
+    //
+    // The order of entities in the destination archetype matches the order of the source entities, as if the matching
+    // archetypes of the query were concatenated:
+    //
+    //     source:      | archetype 0 | archetype 1 |
+    //     destination: |        archetype          |
+    //
+    // such that synchronizing component values is a linear copy over the chunks of both databases rather than a lookup
+    // per entity.
+    //
+    // NOTE(randomuserhi): The destination archetype must only be modified through the link. Destination entities
+    //                     can enable / disable components (e.g to mark asleep rigid bodies), but must not change
+    //                     archetype or be destroyed directly. The link registers with the destination database, which
+    //                     never retires the destination archetype in `Compact`, so it must be destroyed prior the
+    //                     database.
+    class ECDBLink final : NonCopyable {
+    public:
+        // `init` is executed per column for the destination entities created by `Update`, see
+        // `ECDB::Archetype::CreateEntities`.
+        ECDBLink(ECDB* source, const ECDB::Query* query, ECDB* destination, ECDB::Archetype* archetype,
+                 ECDB::Archetype::ColumnFunction init = nullptr);
+        ~ECDBLink();
+
+        // Synchronizes `sourceComponent` of the source entities with `destinationComponent` of the destination
+        // entities. Both components must have the same size and lane layout.
+        ECDBLink& Sync(ComponentId sourceComponent, ComponentId destinationComponent);
+
+        // Creates / destroys destination entities for source entities that started / stopped matching the query and
+        // reorders the destination archetype to match the order of the source entities. Must be called after structural
+        // changes to the source database and prior `Push` / `Pull`.
+        //
+        // Returns true if the destination archetype was changed. If the order already matches, only the entity
+        // metadata of the source chunks is read.
+        bool Update();
+
+        // Copies the synchronized components from the source entities to the destination entities
+        void Push() const;
+
+        // Copies the synchronized components from the destination entities back to the source entities
+        void Pull() const;
+
+        // Returns the destination entity paired with `source`, a null handle if there is none
+        EntityHandle GetLinked(EntityHandle source) const;
+
+        // Number of linked entities
+        Deep_Inline size_t size() const;
+
+        ECDB* const source;
+        const ECDB::Query* const query;
+
+        ECDB* const destination;
+        ECDB::Archetype* const archetype;
+
+    private:
+        struct Link {
+            EntityHandle source;
+            ECDB::EntityPtr* destination;
+
+            // Set whilst updating if the source entity still matches the query
+            bool visited;
+        };
+
+        // Copies the synchronized components in the order of the source entities
+        void Copy(bool push) const;
+
+        // Copies `count` components starting at `srcIndex` of the column `src` to `dstIndex` of the column `dst`
+        static void CopyColumn(ECDB::Archetype::Chunk* dst, size_t dstIndex, ECDB::Archetype::ComponentOffset dstOffset,
+                               ECDB::Archetype::Chunk* src, size_t srcIndex, ECDB::Archetype::ComponentOffset srcOffset,
+                               size_t count);
+
+        const ECDB::Archetype::ColumnFunction init;
+
+        // Pairs of (source component, destination component)
+        std::vector<std::pair<ComponentId, ComponentId>> components;
+
+        // Handles of the source entities in the order of the destination archetype
+        std::vector<EntityHandle> order;
+
+        // Destination entity of each source entity, indexed by the index of the source handle
+        std::vector<Link> links;
+    };
+} // namespace Deep
+
+#include "ECDBLink.inl"
\ No newline at end of file
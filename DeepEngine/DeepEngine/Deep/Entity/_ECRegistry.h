@@ -19,6 +19,54 @@ namespace Deep {
         template<typename T>
         Deep_Inline ComponentId RegisterTag(const char* name = nullptr);
 
+        // Shared components hold a single value per archetype rather than a value per entity. Entities are grouped into
+        // separate archetypes (and thus chunks) by the values of their shared components.
+        ComponentId RegisterSharedComponent(size_t size, size_t alignment, const char* name = nullptr);
+
+        template<typename T>
+        Deep_Inline ComponentId RegisterSharedComponent(const char* name = nullptr);
+
+        // Enableable components can be enabled / disabled per entity without a structural change. Each chunk holds a
+        // bitmask per enableable component marking which of its entities have the component enabled.
+        ComponentId RegisterEnableableComponent(size_t size, size_t alignment, const char* name = nullptr);
+
+        template<typename T>
+        Deep_Inline ComponentId RegisterEnableableComponent(const char* name = nullptr);
+
+        // Laned components are stored inside of a chunk as blocks of `lanes` entities, where each field (of `fieldSize`
+        // bytes) of the component is stored as `lanes` consecutive values (x0..x7, y0..y7, z0..z7 for a Vec3 with 8
+        // lanes) such that a field of `lanes` entities can be loaded into a single SIMD register.
+        //
+        // NOTE(randomuserhi): Laned components are not stored contiguously, so they cannot be accessed by reference.
+        ComponentId RegisterLanedComponent(size_t size, size_t fieldSize, size_t lanes, const char* name = nullptr);
+
+        template<typename T, typename Field = float>
+        Deep_Inline ComponentId RegisterLanedComponent(size_t lanes, const char* name = nullptr);
+
+        // Sparse components are stored in a sparse set per component beside the archetype chunks rather than inside
+        // of them. Adding / removing a sparse component does not move the entity between archetypes, which suits
+        // components that are added / removed frequently (e.g per frame events).
+        //
+        // NOTE(randomuserhi): Sparse components are not part of the archetype of an entity, so they cannot be used in
+        //                     a QueryDesc. Use `Query::Join` to iterate the entities of a query with a sparse
+        //                     component.
+        ComponentId RegisterSparseComponent(size_t size, size_t alignment, const char* name = nullptr);
+
+        template<typename T>
+        Deep_Inline ComponentId RegisterSparseComponent(const char* name = nullptr);
+
+        // Chunk components hold a single value per chunk rather than a value per entity, stored in the chunk header
+        // beside the pointer to the next chunk (e.g a bounding box over the positions of the entities in the chunk).
+        // Queries can test them to skip whole chunks without touching the component columns (see
+        // `ECDB::Archetype::ChunkFilter`).
+        //
+        // NOTE(randomuserhi): Chunk components are zero initialized when a chunk is allocated and are otherwise
+        //                     maintained by the user (e.g a system recomputing them for chunks whose columns have
+        //                     changed).
+        ComponentId RegisterChunkComponent(size_t size, size_t alignment, const char* name = nullptr);
+
+        template<typename T>
+        Deep_Inline ComponentId RegisterChunkComponent(const char* name = nullptr);
         Deep_Inline const ComponentDesc& Get(ComponentId id) const;
 
         // NOTE(randomuserhi): Does not distinguish between tag/component type, only verifies that the id exists.
@@ -28,13 +76,26 @@ namespace Deep {
 
         Deep_Inline static bool IsTag(ComponentId id);
 
+        // NOTE(randomuserhi): Shared components are not considered components as they are not stored per entity.
         Deep_Inline static bool IsComponent(ComponentId id);
 
-        // Strips the tag/component bit to provide the id value.
+        Deep_Inline static bool IsShared(ComponentId id);
+
+        Deep_Inline static bool IsEnableable(ComponentId id);
+
+        Deep_Inline static bool IsSparse(ComponentId id);
+
+        Deep_Inline static bool IsChunk(ComponentId id);
+
+        // Strips the tag/component, shared, enableable, sparse and chunk bits to provide the id value.
         Deep_Inline static ComponentId StripTagBit(ComponentId id);
 
     private:
         static const ComponentId tagBit = 1 << 31;
+        static const ComponentId sharedBit = 1 << 30;
+        static const ComponentId enableableBit = 1 << 29;
+        static const ComponentId sparseBit = 1 << 28;
+        static const ComponentId chunkBit = 1 << 27;
 
         std::vector<ComponentDesc> lookup;
     };
@@ -49,6 +110,21 @@ namespace Deep {
         template<typename T>
         Deep_Inline ComponentId RegisterTag();
 
+        template<typename T>
+        Deep_Inline ComponentId RegisterSharedComponent();
+
+        template<typename T>
+        Deep_Inline ComponentId RegisterEnableableComponent();
+
+        template<typename T, typename Field = float>
+        Deep_Inline ComponentId RegisterLanedComponent(size_t lanes);
+
+        template<typename T>
+        Deep_Inline ComponentId RegisterSparseComponent();
+
+        template<typename T>
+        Deep_Inline ComponentId RegisterChunkComponent();
+
         template<typename T>
         Deep_Inline ComponentId Get();
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Deep {
+    // Stores fixed size values keyed by a uint32 (the index of an entity slot). Values are packed contiguously in
+    // insertion order (with swap-and-pop on erase) and the index of a key's value is found with a paged lookup, such
+    // that inserting / erasing / finding a value is O(1) and iterating the values is a linear walk.
+    //
+    // Used to store sparse components outside of archetype chunks, such that adding / removing them does not move the
+    // entity between archetypes.
+    //
+    // NOTE(randomuserhi): Inserting / erasing invalidates pointers to values.
+    class SparseSet {
+    public:
+        // NOTE(randomuserhi): Values are only aligned up to alignof(std::max_align_t).
+        explicit SparseSet(size_t size, size_t alignment);
+
+        // Returns the value of `key`, `key` must not already exist in the set.
+        // The value is zero initialized.
+        void* Insert(uint32 key);
+
+        // Returns false if `key` does not exist in the set
+        bool Erase(uint32 key);
+
+        // Returns nullptr if `key` does not exist in the set
+        Deep_Inline void* Find(uint32 key) const;
+
+        Deep_Inline bool Has(uint32 key) const;
+
+        Deep_Inline void Clear();
+
+        Deep_Inline size_t size() const;
+
+        // Key / value of the i'th entry
+        Deep_Inline uint32 GetKey(size_t index) const;
+        Deep_Inline void* GetValue(size_t index) const;
+
+    private:
+        // Returns the index of the value of `key`, `size()` if it does not exist
+        Deep_Inline size_t IndexOf(uint32 key) const;
+
+        static const size_t pageSize = 4096;
+
+        size_t valueSize;
+
+        // Index + 1 of the value of each key, 0 if the key does not exist in the set. Pages are allocated on demand.
+        std::vector<std::vector<uint32>> pages;
+
+        std::vector<uint32> keys;
+
+        // NOTE(randomuserhi): Stored as std::max_align_t such that values are suitably aligned.
+        std::vector<std::max_align_t> values;
+    };
+} // namespace Deep
+
+#include "SparseSet.inl"
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Deep/NonCopyable.h>
+#include <Deep/Threading/JobSystem.h>
+
+#include <functional>
+#include <vector>
+
+namespace Deep {
+    // Runs systems over an ECDB using the JobSystem. Each system declares the components it reads / writes and the
+    // scheduler derives the dependencies between systems from them: systems that conflict run in registration order,
+    // all other systems run concurrently.
+    //
+    // Two systems conflict if one writes a component the other reads or writes, or if either is exclusive.
+    //
+    // NOTE(randomuserhi): Systems must only access the components they declare. Structural changes (creating /
+    //                     destroying entities, adding / removing components) and creating queries are not thread safe,
+    //                     so systems must either be declared `Exclusive` or record them in a CommandBuffer.
+    class SystemScheduler final : NonCopyable {
+    public:
+        using SystemFunction = std::function<void(ECDB& database)>;
+
+        struct SystemDesc {
+            explicit Deep_Inline SystemDesc(ECRegistry* registry);
+
+            // The system reads `component`
+            Deep_Inline SystemDesc& Read(ComponentId component) &;
+            Deep_Inline SystemDesc&& Read(ComponentId component) &&;
+
+            // The system writes (and may read) `component`
+            Deep_Inline SystemDesc& Write(ComponentId component) &;
+            Deep_Inline SystemDesc&& Write(ComponentId component) &&;
+
+            // The system runs on its own, after all prior systems and before all later systems (e.g to make structural
+            // changes or play back command buffers)
+            Deep_Inline SystemDesc& Exclusive() &;
+            Deep_Inline SystemDesc&& Exclusive() &&;
+
+            // Returns true if the system cannot run concurrently with `other`
+            bool ConflictsWith(const SystemDesc& other) const;
+
+            ArchetypeBitField reads;
+            ArchetypeBitField writes;
+            bool exclusive = false;
+        };
+
+        Deep_Inline SystemScheduler(ECDB* database, JobSystem* jobSystem);
+
+        // Registers a system and returns its index. The system runs after every previously registered system it
+        // conflicts with.
+        size_t Register(SystemDesc&& description, SystemFunction function);
+
+        // Runs every registered system once, returns once all systems have completed
+        void Run();
+
+        // Systems that `system` directly waits on
+        Deep_Inline const std::vector<size_t>& GetDependencies(size_t system) const;
+
+        Deep_Inline size_t size() const;
+
+        ECDB* const database;
+        JobSystem* const jobSystem;
+
+    private:
+        struct System {
+            SystemDesc description;
+            SystemFunction function;
+
+            // Systems this system waits on
+            std::vector<size_t> dependencies;
+
+            // Systems waiting on this system
+            std::vector<size_t> dependents;
+        };
+
+        std::vector<System> systems;
+
+        // Job of each system whilst running
+        std::vector<Job> jobs;
+    };
+} // namespace Deep
+
+#include "SystemScheduler.inl"
\ No newline at end of file
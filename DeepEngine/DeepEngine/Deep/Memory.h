@@ -8,7 +8,9 @@ namespace Deep {
     Deep_Inline void Free(void* block);
     Deep_Inline void* AlignedMalloc(size_t size, size_t alignment);
     Deep_Inline void AlignedFree(void* pointer);
-    Deep_Inline void* Memcpy(void* dest, void* src, size_t size);
+    Deep_Inline void* Memcpy(void* dest, const void* src, size_t size);
+    // Fills `dest` with `count` copies of the value of size `size` at `src`
+    Deep_Inline void* MemcpyFill(void* dest, const void* src, size_t size, size_t count);
 } // namespace Deep
 
 #include "Memory.inl"
\ No newline at end of file
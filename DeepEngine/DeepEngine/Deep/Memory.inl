@@ -38,7 +38,25 @@ namespace Deep {
 #endif
     }
 
-    void* Memcpy(void* dest, void* src, size_t size) {
+    void* Memcpy(void* dest, const void* src, size_t size) {
         return std::memcpy(dest, src, size);
     }
+
+    void* MemcpyFill(void* dest, const void* src, size_t size, size_t count) {
+        if (count == 0) return dest;
+
+        uint8* bytes = reinterpret_cast<uint8*>(dest);
+        const size_t total = size * count;
+
+        // Copy the first value, then double the filled region each iteration such that large fills use wide copies
+        std::memcpy(bytes, src, size);
+        size_t filled = size;
+        while (filled < total) {
+            size_t n = filled < total - filled ? filled : total - filled;
+            std::memcpy(bytes + filled, bytes, n);
+            filled += n;
+        }
+
+        return dest;
+    }
 } // namespace Deep
\ No newline at end of file
@@ -0,0 +1,181 @@
+/**
+ * SlabAllocator
+ */
+
+#include <Deep/Memory/SlabAllocator.h>
+
+#include <algorithm>
+
+#if defined(DEEP_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace Deep {
+    SlabAllocator::SlabAllocator(size_t blockSize, size_t slabSize, bool useHugePages) :
+        blockSize((blockSize + DEEP_CACHE_LINE_SIZE - 1) / DEEP_CACHE_LINE_SIZE * DEEP_CACHE_LINE_SIZE),
+        slabSize(useHugePages ? (std::max(slabSize, this->blockSize) + hugePageSize - 1) / hugePageSize * hugePageSize
+                              : std::max(slabSize, this->blockSize)),
+        blocksPerSlab(this->slabSize / this->blockSize),
+        useHugePages(useHugePages) {
+        Deep_Assert(blockSize >= sizeof(void*), "Blocks must be able to hold a pointer to the next free block.");
+    }
+
+    SlabAllocator::~SlabAllocator() {
+        for (const Slab& slab : slabs) {
+            FreeSlab(slab.memory, slabSize);
+        }
+    }
+
+    SlabAllocator::Slab& SlabAllocator::FindSlab(void* block) {
+        uint8* address = reinterpret_cast<uint8*>(block);
+
+        // Find the last slab that starts at or before `address`
+        auto it = std::upper_bound(slabs.begin(), slabs.end(), address, [](const uint8* a, const Slab& slab) {
+            return std::less<const uint8*>()(a, slab.memory);
+        });
+        Deep_Assert(it != slabs.begin(), "Block was not allocated by this allocator.");
+        --it;
+        Deep_Assert(address < it->memory + slabSize, "Block was not allocated by this allocator.");
+
+        return *it;
+    }
+
+    void* SlabAllocator::Allocate() {
+        void* block;
+
+        if (firstFree != nullptr) {
+            // Take block from free list
+
+            block = firstFree;
+            firstFree = *reinterpret_cast<void**>(block);
+        } else {
+            if (carve == carveEnd) {
+                // Newest slab is exhausted, allocate a new slab
+
+                uint8* memory = AllocateSlab(slabSize, useHugePages);
+                Deep_Assert(memory != nullptr, "Failed to allocate slab.");
+
+                auto it = std::upper_bound(slabs.begin(), slabs.end(), memory, [](const uint8* a, const Slab& slab) {
+                    return std::less<const uint8*>()(a, slab.memory);
+                });
+                slabs.insert(it, { memory, 0 });
+
+                carve = memory;
+                carveEnd = memory + blocksPerSlab * blockSize;
+            }
+
+            block = carve;
+            carve += blockSize;
+        }
+
+        ++FindSlab(block).numAllocated;
+
+        return block;
+    }
+
+    void SlabAllocator::Free(void* block) {
+        Deep_Assert(block != nullptr, "Cannot free a nullptr.");
+
+        Slab& slab = FindSlab(block);
+        Deep_Assert(slab.numAllocated > 0, "Slab does not contain any allocated blocks.");
+        --slab.numAllocated;
+
+        *reinterpret_cast<void**>(block) = firstFree;
+        firstFree = block;
+    }
+
+    size_t SlabAllocator::Trim() {
+        // Remove the blocks of empty slabs from the free list
+        void** link = &firstFree;
+        while (*link != nullptr) {
+            void* block = *link;
+            if (FindSlab(block).numAllocated == 0) {
+                *link = *reinterpret_cast<void**>(block);
+            } else {
+                link = reinterpret_cast<void**>(block);
+            }
+        }
+
+        size_t released = 0;
+        for (size_t i = 0; i < slabs.size();) {
+            Slab& slab = slabs[i];
+            if (slab.numAllocated != 0) {
+                ++i;
+                continue;
+            }
+
+            if (carve >= slab.memory && carve <= slab.memory + slabSize) {
+                carve = nullptr;
+                carveEnd = nullptr;
+            }
+
+            FreeSlab(slab.memory, slabSize);
+            released += slabSize;
+
+            slabs.erase(slabs.begin() + i);
+        }
+
+        return released;
+    }
+} // namespace Deep
+
+// Platform specific slab allocation
+namespace Deep {
+#if defined(DEEP_PLATFORM_WINDOWS)
+
+    uint8* SlabAllocator::AllocateSlab(size_t size, bool useHugePages) {
+        if (useHugePages) {
+            // NOTE(randomuserhi): Large pages require the SeLockMemoryPrivilege, if not held the allocation fails and
+            //                     regular pages are used instead.
+            size_t largePageSize = GetLargePageMinimum();
+            if (largePageSize != 0 && size % largePageSize == 0) {
+                void* memory = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                if (memory != nullptr) return reinterpret_cast<uint8*>(memory);
+            }
+        }
+
+        return reinterpret_cast<uint8*>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+    }
+
+    void SlabAllocator::FreeSlab(uint8* memory, size_t size) {
+        VirtualFree(memory, 0, MEM_RELEASE);
+    }
+
+#else
+
+    uint8* SlabAllocator::AllocateSlab(size_t size, bool useHugePages) {
+        if (!useHugePages) {
+            void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            return memory != MAP_FAILED ? reinterpret_cast<uint8*>(memory) : nullptr;
+        }
+
+        // Huge pages can only back memory aligned to the huge page size, so map an extra huge page and unmap the
+        // unaligned ends
+        size_t mappedSize = size + hugePageSize;
+        void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) return nullptr;
+
+        uint8* begin = reinterpret_cast<uint8*>(mapped);
+        uint8* memory = reinterpret_cast<uint8*>((reinterpret_cast<uintptr_t>(begin) + hugePageSize - 1)
+                                                 & ~static_cast<uintptr_t>(hugePageSize - 1));
+        uint8* end = begin + mappedSize;
+
+        if (memory != begin) munmap(begin, memory - begin);
+        if (memory + size != end) munmap(memory + size, end - (memory + size));
+
+#if defined(MADV_HUGEPAGE)
+        madvise(memory, size, MADV_HUGEPAGE);
+#endif
+
+        return memory;
+    }
+
+    void SlabAllocator::FreeSlab(uint8* memory, size_t size) {
+        munmap(memory, size);
+    }
+
+#endif
+} // namespace Deep
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Deep.h>
+#include <Deep/NonCopyable.h>
+
+#include <vector>
+
+namespace Deep {
+    // Allocates fixed size blocks out of large slabs of memory. Freed blocks are pooled and reused by later
+    // allocations, and slabs that no longer contain any allocated block can be returned to the OS with `Trim`.
+    //
+    // Slabs are allocated directly from the OS (`mmap` / `VirtualAlloc`) and can optionally be backed by huge pages,
+    // reducing TLB misses when iterating over the blocks.
+    //
+    // NOTE(randomuserhi): Not thread safe.
+    class SlabAllocator final : NonCopyable {
+    public:
+        static const size_t hugePageSize = 2 * 1024 * 1024;
+
+        // `blockSize` is rounded up to a multiple of DEEP_CACHE_LINE_SIZE such that every block is cache line aligned.
+        // `slabSize` is rounded up such that a slab fits atleast 1 block (and to a multiple of `hugePageSize` if huge
+        // pages are used).
+        explicit SlabAllocator(size_t blockSize, size_t slabSize = hugePageSize, bool useHugePages = false);
+        ~SlabAllocator();
+
+        void* Allocate();
+
+        void Free(void* block);
+
+        // Returns slabs that contain no allocated blocks to the OS. Returns the number of bytes released.
+        size_t Trim();
+
+        Deep_Inline size_t GetBlockSize() const;
+
+        // Number of bytes currently allocated from the OS
+        Deep_Inline size_t GetReservedSize() const;
+
+    private:
+        struct Slab {
+            uint8* memory;
+
+            // Number of blocks of this slab in use
+            size_t numAllocated;
+        };
+
+        // Returns the slab containing `block`
+        Slab& FindSlab(void* block);
+
+        // NOTE(randomuserhi): Falls back to regular pages if huge pages are unavailable.
+        static uint8* AllocateSlab(size_t size, bool useHugePages);
+        static void FreeSlab(uint8* memory, size_t size);
+
+        const size_t blockSize;
+        const size_t slabSize;
+        const size_t blocksPerSlab;
+        const bool useHugePages;
+
+        // NOTE(randomuserhi): Sorted by address such that the slab of a block can be found with a binary search.
+        std::vector<Slab> slabs;
+
+        // Free blocks, linked through the first bytes of each block
+        void* firstFree = nullptr;
+
+        // Remaining region of the newest slab that has not been handed out yet. Blocks are carved out of the slab on
+        // demand such that untouched memory is never committed.
+        uint8* carve = nullptr;
+        uint8* carveEnd = nullptr;
+    };
+} // namespace Deep
+
+#include "SlabAllocator.inl"
\ No newline at end of file
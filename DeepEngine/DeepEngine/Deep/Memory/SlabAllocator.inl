@@ -0,0 +1,11 @@
+#pragma once
+
+namespace Deep {
+    size_t SlabAllocator::GetBlockSize() const {
+        return blockSize;
+    }
+
+    size_t SlabAllocator::GetReservedSize() const {
+        return slabs.size() * slabSize;
+    }
+} // namespace Deep
\ No newline at end of file
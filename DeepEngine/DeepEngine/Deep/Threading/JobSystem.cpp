@@ -11,6 +11,11 @@ namespace Deep {
         Deep_Assert(numThreads > 0, "Number of threads must be greater than 0.");
         Deep_Assert(maxBarriers > 0, "Maximum number of barriers must be greater than 0.");
 
+        // NOTE(randomuserhi): std::atomic is not value initialized, threads treat non-nullptr slots as queued jobs.
+        for (size_t i = 0; i < queueLength; ++i) {
+            queue[i] = nullptr;
+        }
+
         StartThreads();
     }
 
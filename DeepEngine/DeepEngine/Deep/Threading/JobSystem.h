@@ -74,7 +74,7 @@ namespace Deep {
             static constexpr intptr_t barrierDoneState = ~intptr_t(0);
 
             // Number of references to this job. Used for reference counting to free the job.
-            std::atomic<uint32> referenceCount;
+            std::atomic<uint32> referenceCount = 0;
 
             // Number of dependencies left before this job can execute
             // NOTE(randomuserhi): Also stores the job state, refer to `executingState` and `doneState`
@@ -2,6 +2,8 @@
 #include <Deep.h>
 #include <Deep/Entity.h>
 
+#include <atomic>
+
 TEST(ArchetypeBitField, Hash) {
     Deep::ECRegistry registry;
     Deep::ArchetypeBitField a{ &registry };
@@ -134,4 +136,1568 @@ TEST(ECDB, Archetype) {
     // Verify component array offsets (Each should be aligned to DEEP_CACHE_LINE_SIZE)
     EXPECT_EQ(arch.GetComponentOffset(comp[0]).offset, 8192);
     EXPECT_EQ(arch.GetComponentOffset(comp[1]).offset, 12288);
+}
+
+TEST(ECDB, Query) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId a = registry.RegisterComponent<Component>();
+    Deep::ComponentId b = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(a).Without(tag));
+
+    // Queries with the same description are shared
+    EXPECT_EQ(&query, &database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(a).Without(tag)));
+    EXPECT_EQ(query.archetypes().size(), 0);
+
+    for (size_t i = 0; i < 10; ++i) {
+        database.Entity().AddComponent(a);
+        database.Entity().AddComponent(a).AddComponent(b);
+        database.Entity().AddComponent(a).AddComponent(tag);
+        database.Entity().AddComponent(b);
+    }
+
+    // Archetypes created after the query are tracked
+    EXPECT_EQ(query.archetypes().size(), 2);
+    EXPECT_EQ(query.size(), 20);
+
+    // Archetypes created prior the query are matched on creation of the query
+    Deep::ECDB::Query& any = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.Any(b).Any(tag));
+    EXPECT_EQ(any.archetypes().size(), 3);
+    EXPECT_EQ(any.size(), 30);
+}
+
+TEST(ECDB, CommandBuffer) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::Entt entt = database.Entity();
+
+    Deep::ECDB::CommandBuffer buffer{ &database };
+    buffer.AddComponent(entt, comp);
+    buffer.SetComponent(entt, comp, Component{ 10 });
+
+    Deep::ECDB::CommandBuffer::DeferredEntt created = buffer.Entity();
+    buffer.AddComponent(created, comp);
+    buffer.AddComponent(created, tag);
+    buffer.SetComponent(created, comp, Component{ 20 });
+
+    Deep::ECDB::CommandBuffer::DeferredEntt destroyed = buffer.Entity();
+    buffer.AddComponent(destroyed, comp);
+    buffer.Destroy(destroyed);
+
+    // Commands are not applied until playback
+    EXPECT_EQ(database.GetRootArchetype().size(), 1);
+
+    database.Playback(buffer);
+    EXPECT_TRUE(buffer.IsEmpty());
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+    EXPECT_EQ(arch.size(), 1);
+    EXPECT_EQ(arch.GetComponent<Component>(entt, comp).a, 10);
+
+    Deep::ComponentId tagArr[] = { comp, tag };
+    Deep::ECDB::Archetype& tagArch = database.GetArchetype(tagArr, 2);
+    EXPECT_EQ(tagArch.size(), 1);
+
+    const Deep::ECDB::Archetype::Metadata* metadata = Deep::ECDB::Archetype::GetMetaList(tagArch.chunks());
+    EXPECT_EQ(tagArch.GetComponent<Component>(metadata[0].entt, comp).a, 20);
+}
+
+TEST(ECDB, CommandBufferOrder) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId other = registry.RegisterTag();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    // `a` is in an archetype created prior the archetype of `b`
+    Deep::Entt a = database.Entity().AddComponent(comp);
+    Deep::Entt b = database.Entity().AddComponent(comp).AddComponent(other);
+    Deep::ComponentId aArr[] = { comp };
+    database.GetArchetype(aArr, 1).GetComponent<Component>(a, comp).a = 10;
+    Deep::ComponentId bArr[] = { comp, other };
+    database.GetArchetype(bArr, 2).GetComponent<Component>(b, comp).a = 20;
+
+    Deep::ComponentId dstArr[] = { comp, tag };
+    Deep::ECDB::Archetype& destination = database.GetArchetype(dstArr, 2);
+
+    Deep::ECDB::CommandBuffer buffer{ &database };
+    buffer.RemoveComponent(b, other);
+    buffer.AddComponent(b, tag);
+    buffer.AddComponent(a, tag);
+    for (int i = 1; i <= 3; ++i) {
+        Deep::ECDB::CommandBuffer::DeferredEntt created = buffer.Entity(&destination);
+        buffer.SetComponent(created, comp, Component{ i });
+    }
+
+    database.Playback(buffer);
+
+    // Created entities are placed first in the order of their commands, followed by moved entities in the order of
+    // the creation of their source archetypes, independent of the addresses of the archetypes.
+    ASSERT_EQ(destination.size(), 5);
+    const Deep::ECDB::Archetype::Metadata* metadata = Deep::ECDB::Archetype::GetMetaList(destination.chunks());
+    int expected[] = { 1, 2, 3, 10, 20 };
+    for (size_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(destination.GetComponent<Component>(metadata[i].entt, comp).a, expected[i]);
+    }
+}
+
+TEST(ECDB, TradeChunks) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+
+    size_t numEntities = 10000;
+
+    for (size_t i = 0; i < numEntities; ++i) {
+        Deep::Entt entt = arch.Entity();
+        arch.GetComponent<Component>(entt, comp).a = static_cast<int>(i);
+    }
+
+    Deep::ComponentId tagArr[] = { comp, tag };
+    Deep::ECDB::Archetype& tagArch = database.GetArchetype(tagArr, 2);
+    EXPECT_TRUE(arch.SharesLayout(tagArch));
+
+    // Adding a tag to a whole archetype trades its chunks
+    database.AddComponent(arch, tag);
+    EXPECT_EQ(arch.size(), 0);
+    EXPECT_EQ(tagArch.size(), numEntities);
+
+    size_t size = 0;
+    Deep::ECDB::Archetype::ComponentOffset offset = tagArch.GetComponentOffset(comp);
+    for (Deep::ECDB::Archetype::Chunk* c = tagArch.chunks(); c != nullptr; c = tagArch.GetNextChunk(c)) {
+        const Deep::ECDB::Archetype::Metadata* metadata = Deep::ECDB::Archetype::GetMetaList(c);
+        Component* comps = tagArch.GetCompList<Component>(c, offset);
+        for (size_t i = 0; i < tagArch.GetChunkSize(c); ++i, ++size) {
+            EXPECT_EQ(tagArch.GetComponent<Component>(metadata[i].entt, comp).a, comps[i].a);
+        }
+    }
+    EXPECT_EQ(size, numEntities);
+}
+
+TEST(ECDB, CreateEntities) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+
+    size_t numEntities = 10000;
+
+    Component value{ 10 };
+    const void* prototype[] = { &value };
+    std::vector<Deep::Entt> entities = arch.CreateEntities(numEntities, prototype);
+
+    EXPECT_EQ(entities.size(), numEntities);
+    EXPECT_EQ(arch.size(), numEntities);
+
+    for (size_t i = 0; i < numEntities; ++i) {
+        const Deep::ECDB::Archetype::Metadata& metadata = arch.GetMeta(entities[i]);
+        EXPECT_EQ(metadata.entt, entities[i]);
+        EXPECT_EQ(arch.GetComponent<Component>(entities[i], comp).a, 10);
+    }
+}
+
+TEST(ECDB, Destroy) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::Entt entt = database.Entity();
+    entt.AddComponent(comp);
+    entt.Destroy();
+
+    // The destroyed entity's slot is reused
+    Deep::Entt reused = database.Entity();
+    EXPECT_TRUE(reused == entt);
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+    EXPECT_EQ(arch.size(), 0);
+
+    size_t numEntities = 10000;
+
+    for (size_t i = 0; i < numEntities; ++i) {
+        Deep::Entt e = database.Entity();
+        e.AddComponent(comp);
+        if (i % 2 == 0) e.AddComponent(tag);
+    }
+
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(tag));
+    EXPECT_EQ(query.size(), numEntities / 2);
+
+    database.DestroyAll(query);
+    EXPECT_EQ(query.size(), 0);
+    EXPECT_EQ(arch.size(), numEntities / 2);
+}
+
+TEST(ECDB, TransitionPlan) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp[] = { registry.RegisterComponent<Component>(), registry.RegisterComponent<Component>(),
+                                 registry.RegisterComponent<Component>(), registry.RegisterComponent<Component>() };
+
+    // NOTE(randomuserhi): comp[1] and comp[3] map to the same offset bucket in an archetype of 2 components
+    Deep::ComponentId compArr[] = { comp[1], comp[3] };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 2);
+    EXPECT_NE(arch.GetComponentOffset(comp[1]).offset, arch.GetComponentOffset(comp[3]).offset);
+
+    Deep::ComponentId otherArr[] = { comp[3] };
+    Deep::ECDB::Archetype& other = database.GetArchetype(otherArr, 1);
+
+    // Only the shared component is copied
+    Deep::ECDB::Archetype::TransitionPlan plan = other.GetTransitionPlan(arch);
+    EXPECT_EQ(plan.size(), 1);
+    EXPECT_EQ(plan[0].srcOffset, arch.GetComponentOffset(comp[3]).offset);
+    EXPECT_EQ(plan[0].dstOffset, other.GetComponentOffset(comp[3]).offset);
+
+    Deep::Entt entt = arch.Entity();
+    arch.GetComponent<Component>(entt, comp[1]).a = 10;
+    arch.GetComponent<Component>(entt, comp[3]).a = 20;
+
+    entt.RemoveComponent(comp[1]);
+    EXPECT_EQ(other.GetComponent<Component>(entt, comp[3]).a, 20);
+
+    entt.AddComponent(comp[1]);
+    EXPECT_EQ(arch.GetComponent<Component>(entt, comp[3]).a, 20);
+}
+
+TEST(ECDB, ChangeVersion) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId a = registry.RegisterComponent<Component>();
+    Deep::ComponentId b = registry.RegisterComponent<Component>();
+    Deep::ComponentId compArr[] = { a, b };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 2);
+
+    std::vector<Deep::Entt> entities = arch.CreateEntities(10000);
+
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.Changed(a));
+
+    size_t numChunks = 0;
+    for (Deep::ECDB::Archetype::Chunk* c = arch.chunks(); c != nullptr; c = arch.GetNextChunk(c)) {
+        ++numChunks;
+    }
+
+    auto countChunks = [&query](uint64 sinceVersion) {
+        size_t count = 0;
+        query.ForEachChunk(nullptr, 0,
+                           [&count](const Deep::ECDB::Archetype*, Deep::ECDB::Archetype::Chunk*, size_t,
+                                    const Deep::ECDB::Archetype::ComponentOffset*) { ++count; },
+                           sinceVersion);
+        return count;
+    };
+
+    // Creating entities is a change
+    uint64 lastVersion = database.GetVersion();
+    EXPECT_EQ(countChunks(lastVersion - 1), numChunks);
+
+    database.Tick();
+    EXPECT_EQ(countChunks(lastVersion), 0);
+
+    // Writing to a different component is not a change to `a`
+    arch.GetComponent<Component>(entities[0], b).a = 10;
+    EXPECT_EQ(countChunks(lastVersion), 0);
+
+    // Reading is not a change
+    EXPECT_EQ(arch.GetComponent<const Component>(entities[0], a).a, arch.GetComponent<const Component>(entities[0], a).a);
+    EXPECT_EQ(countChunks(lastVersion), 0);
+
+    arch.GetComponent<Component>(entities[0], a).a = 10;
+    EXPECT_EQ(countChunks(lastVersion), 1);
+
+    // A version of 0 includes all chunks
+    EXPECT_EQ(countChunks(0), numChunks);
+}
+
+TEST(ECDB, SharedComponent) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId shared = registry.RegisterSharedComponent<Component>();
+    EXPECT_TRUE(Deep::ECRegistry::IsShared(shared));
+    EXPECT_FALSE(Deep::ECRegistry::IsComponent(shared));
+    EXPECT_FALSE(Deep::ECRegistry::IsTag(shared));
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+
+    std::vector<Deep::Entt> entities = arch.CreateEntities(100);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        arch.GetComponent<Component>(entities[i], comp).a = static_cast<int>(i);
+        entities[i].SetSharedComponent(shared, Component{ static_cast<int>(i % 2) });
+    }
+    EXPECT_EQ(arch.size(), 0);
+
+    // Each shared value partitions the entities into its own archetype
+    Component zero{ 0 };
+    Component one{ 1 };
+    Deep::ECDB::Archetype& even = database.GetArchetype(
+        Deep::ECDB::ArchetypeDesc{ &registry }.AddComponent(comp).SetSharedComponent(shared, &zero));
+    Deep::ECDB::Archetype& odd = database.GetArchetype(
+        Deep::ECDB::ArchetypeDesc{ &registry }.AddComponent(comp).SetSharedComponent(shared, &one));
+    EXPECT_NE(&even, &odd);
+    EXPECT_EQ(even.size(), 50);
+    EXPECT_EQ(odd.size(), 50);
+    EXPECT_EQ(even.GetSharedComponent<Component>(shared).a, 0);
+    EXPECT_EQ(odd.GetSharedComponent<Component>(shared).a, 1);
+    EXPECT_EQ(odd.GetComponent<Component>(entities[1], comp).a, 1);
+
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(shared));
+    EXPECT_EQ(query.archetypes().size(), 2);
+    EXPECT_EQ(query.size(), entities.size());
+
+    // Changing the value of a whole archetype trades its chunks
+    database.SetSharedComponent(odd, shared, &zero);
+    EXPECT_EQ(odd.size(), 0);
+    EXPECT_EQ(even.size(), entities.size());
+
+    // Removing the shared component returns entities to the archetype without it
+    entities[0].RemoveComponent(shared);
+    EXPECT_EQ(arch.size(), 1);
+    EXPECT_EQ(arch.GetComponent<Component>(entities[0], comp).a, 0);
+}
+
+TEST(ECDB, EnableableComponent) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId enableable = registry.RegisterEnableableComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+    EXPECT_TRUE(Deep::ECRegistry::IsEnableable(enableable));
+    EXPECT_TRUE(Deep::ECRegistry::IsComponent(enableable));
+    EXPECT_FALSE(Deep::ECRegistry::IsEnableable(comp));
+
+    Deep::ComponentId compArr[] = { comp, enableable };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 2);
+
+    std::vector<Deep::Entt> entities = arch.CreateEntities(1000);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        // Components are enabled by default
+        EXPECT_TRUE(entities[i].IsEnabled(enableable));
+        EXPECT_TRUE(entities[i].IsEnabled(comp));
+
+        arch.GetComponent<Component>(entities[i], comp).a = static_cast<int>(i);
+        if (i % 3 != 0) entities[i].SetEnabled(enableable, false);
+    }
+
+    // Toggling does not move the entity
+    EXPECT_EQ(arch.size(), entities.size());
+
+    auto countEnabled = [&](Deep::ECDB::Archetype& archetype) {
+        Deep::ECDB::Archetype::ComponentOffset offsets[] = { archetype.GetComponentOffset(comp),
+                                                             archetype.GetComponentOffset(enableable) };
+        size_t count = 0;
+        for (Deep::ECDB::Archetype::Chunk* c = archetype.chunks(); c != nullptr; c = archetype.GetNextChunk(c)) {
+            const Component* comps = archetype.GetCompList<const Component>(c, offsets[0]);
+            Deep::ECDB::Archetype::ForEachEnabled(c, archetype.GetChunkSize(c), offsets, 2, [&](size_t i) {
+                EXPECT_EQ(comps[i].a % 3, 0);
+                ++count;
+            });
+        }
+        return count;
+    };
+    EXPECT_EQ(countEnabled(arch), 334);
+
+    // Removing an entity from the middle of a chunk keeps the enabled bits of the entity filling the gap
+    entities[1].Destroy();
+    EXPECT_EQ(countEnabled(arch), 334);
+    entities[0].Destroy();
+    EXPECT_EQ(countEnabled(arch), 333);
+
+    // Enabled bits are carried over when moving between archetypes
+    for (size_t i = 2; i < entities.size(); ++i) {
+        entities[i].AddComponent(tag);
+    }
+    Deep::ComponentId tagArr[] = { comp, enableable, tag };
+    Deep::ECDB::Archetype& tagArch = database.GetArchetype(tagArr, 3);
+    EXPECT_EQ(countEnabled(tagArch), 333);
+    EXPECT_TRUE(entities[3].IsEnabled(enableable));
+    EXPECT_FALSE(entities[4].IsEnabled(enableable));
+}
+
+TEST(ECDB, Snapshot) {
+    Deep::ECRegistry registry;
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId enableable = registry.RegisterEnableableComponent<Component>();
+    Deep::ComponentId shared = registry.RegisterSharedComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    std::vector<uint8> snapshot;
+    {
+        Deep::ECDB database{ &registry };
+
+        Deep::ComponentId compArr[] = { comp, enableable };
+        Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 2);
+        std::vector<Deep::Entt> entities = arch.CreateEntities(10000);
+        for (size_t i = 0; i < entities.size(); ++i) {
+            arch.GetComponent<Component>(entities[i], comp).a = static_cast<int>(i);
+            if (i % 2 == 0) entities[i].SetEnabled(enableable, false);
+        }
+        for (size_t i = 0; i < 100; ++i) {
+            entities[i].AddComponent(tag).SetSharedComponent(shared, Component{ 7 });
+        }
+        database.Entity();
+
+        database.SaveSnapshot(snapshot);
+    }
+
+    Deep::ECDB database{ &registry };
+    EXPECT_FALSE(database.LoadSnapshot(snapshot.data(), snapshot.size() / 2));
+    EXPECT_TRUE(database.LoadSnapshot(snapshot.data(), snapshot.size()));
+
+    EXPECT_EQ(database.GetRootArchetype().size(), 1);
+
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(comp));
+    EXPECT_EQ(query.size(), 10000);
+
+    // Entities are rebuilt with their component values and enabled state
+    std::vector<bool> found(10000, false);
+    for (Deep::ECDB::Archetype* arch : query.archetypes()) {
+        for (Deep::ECDB::Archetype::Chunk* c = arch->chunks(); c != nullptr; c = arch->GetNextChunk(c)) {
+            const Deep::ECDB::Archetype::Metadata* metadata = Deep::ECDB::Archetype::GetMetaList(c);
+            for (size_t i = 0; i < arch->GetChunkSize(c); ++i) {
+                int value = arch->GetComponent<const Component>(metadata[i].entt, comp).a;
+                EXPECT_FALSE(found[value]);
+                found[value] = true;
+
+                EXPECT_EQ(arch->IsEnabled(metadata[i].entt, enableable), value % 2 != 0);
+                EXPECT_EQ(arch->description.HasComponent(tag), value < 100);
+                if (value < 100) {
+                    EXPECT_EQ(arch->GetSharedComponent<Component>(shared).a, 7);
+                }
+            }
+        }
+    }
+
+    // Loaded entities behave like any other entity
+    Deep::ECDB::Archetype* arch = query.archetypes()[0];
+    Deep::Entt entt{ &database, Deep::ECDB::Archetype::GetMetaList(arch->chunks())[0].entt };
+    entt.RemoveComponent(comp);
+    EXPECT_EQ(query.size(), 9999);
+}
+
+TEST(ECDB, SnapshotValidation) {
+    Deep::ECRegistry registry;
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+
+    std::vector<uint8> snapshot;
+    {
+        Deep::ECDB database{ &registry };
+
+        Deep::ComponentId compArr[] = { comp };
+        database.GetArchetype(compArr, 1).CreateEntities(1000);
+
+        database.SaveSnapshot(snapshot);
+    }
+
+    // Locate the Metadata array of the first chunk, which holds the entity indices 0, 1, 2, 3, ...
+    size_t indices[] = { 0, 1, 2, 3 };
+    size_t metadata = snapshot.size();
+    for (size_t i = 0; i + sizeof(indices) <= snapshot.size(); i += DEEP_CACHE_LINE_SIZE) {
+        if (memcmp(snapshot.data() + i, indices, sizeof(indices)) == 0) {
+            metadata = i;
+            break;
+        }
+    }
+    ASSERT_NE(metadata, snapshot.size());
+
+    auto setIndex = [&snapshot, metadata](size_t entity, size_t index) {
+        memcpy(snapshot.data() + metadata + entity * sizeof(size_t), &index, sizeof(size_t));
+    };
+
+    Deep::ECDB database{ &registry };
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(comp));
+
+    // Out of range entity index
+    setIndex(1, 1000);
+    EXPECT_FALSE(database.LoadSnapshot(snapshot.data(), snapshot.size()));
+
+    // Entity index that appears twice
+    setIndex(1, 0);
+    EXPECT_FALSE(database.LoadSnapshot(snapshot.data(), snapshot.size()));
+
+    // Failed loads do not create archetypes
+    EXPECT_EQ(query.archetypes().size(), 0);
+
+    setIndex(1, 1);
+    EXPECT_TRUE(database.LoadSnapshot(snapshot.data(), snapshot.size()));
+    EXPECT_EQ(query.size(), 1000);
+
+    // Archetypes of the snapshot already contain entities
+    EXPECT_FALSE(database.LoadSnapshot(snapshot.data(), snapshot.size()));
+    EXPECT_EQ(query.size(), 1000);
+}
+
+TEST(ECDB, Fork) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+
+    std::vector<Deep::Entt> entities = arch.CreateEntities(5000);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        arch.GetComponent<Component>(entities[i], comp).a = static_cast<int>(i);
+    }
+
+    Deep::ECDB::ForkState* fork = database.Fork();
+    Deep::ECDB::ForkState* other = database.Fork();
+
+    // Writes after the fork do not affect the fork
+    for (size_t i = 0; i < 100; ++i) {
+        arch.GetComponent<Component>(entities[i], comp).a = -1;
+    }
+    for (size_t i = 100; i < 200; ++i) {
+        entities[i].AddComponent(tag);
+    }
+    for (size_t i = 200; i < 300; ++i) {
+        entities[i].Destroy();
+    }
+    std::vector<Deep::Entt> created = arch.CreateEntities(1000);
+    EXPECT_EQ(arch.size(), 5800);
+
+    database.Restore(fork);
+    EXPECT_EQ(arch.size(), entities.size());
+    EXPECT_EQ(database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(tag)).size(), 0);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        EXPECT_EQ(arch.GetComponent<const Component>(entities[i], comp).a, static_cast<int>(i));
+    }
+
+    // Restored entities behave like any other entity
+    entities[0].AddComponent(tag);
+    arch.GetComponent<Component>(entities[1], comp).a = -1;
+    arch.CreateEntities(10);
+
+    // Releasing a fork does not affect other forks
+    database.Release(fork);
+    database.Restore(other);
+    EXPECT_EQ(arch.size(), entities.size());
+    for (size_t i = 0; i < entities.size(); ++i) {
+        EXPECT_EQ(arch.GetComponent<const Component>(entities[i], comp).a, static_cast<int>(i));
+    }
+
+    // A fork can be restored multiple times
+    entities[5].Destroy();
+    database.Restore(other);
+    EXPECT_EQ(arch.GetComponent<const Component>(entities[5], comp).a, 5);
+    EXPECT_EQ(arch.size(), entities.size());
+}
+
+TEST(ECDB, ChunkPool) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry, 16384, true };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId other = registry.RegisterComponent<Component>();
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ComponentId otherArr[] = { other };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+    Deep::ECDB::Archetype& otherArch = database.GetArchetype(otherArr, 1);
+
+    arch.CreateEntities(10000);
+    EXPECT_EQ(database.Trim(), 0);
+
+    // Chunks released by one archetype are reused by another archetype of the same size
+    database.DestroyAll(arch);
+    std::vector<Deep::Entt> entities = otherArch.CreateEntities(10000);
+    EXPECT_EQ(database.Trim(), 0);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        otherArch.GetComponent<Component>(entities[i], other).a = static_cast<int>(i);
+    }
+    for (size_t i = 0; i < entities.size(); ++i) {
+        EXPECT_EQ(otherArch.GetComponent<const Component>(entities[i], other).a, static_cast<int>(i));
+    }
+
+    // Empty slabs are returned to the OS
+    database.DestroyAll(otherArch);
+    EXPECT_GT(database.Trim(), 0);
+    EXPECT_EQ(database.Trim(), 0);
+
+    arch.CreateEntities(100);
+    EXPECT_EQ(arch.size(), 100);
+}
+
+TEST(ECDB, Compact) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(comp));
+
+    Deep::ComponentId compArr[] = { comp };
+    std::vector<Deep::Entt> entities = database.GetArchetype(compArr, 1).CreateEntities(5000);
+    for (size_t i = 0; i < 100; ++i) {
+        entities[i].AddComponent(tag);
+    }
+    EXPECT_EQ(query.archetypes().size(), 2);
+
+    // Archetypes with entities are kept
+    EXPECT_TRUE(database.Compact(std::chrono::milliseconds(100)));
+    EXPECT_EQ(query.archetypes().size(), 2);
+
+    // Empty archetypes are retired
+    for (size_t i = 0; i < 100; ++i) {
+        entities[i].RemoveComponent(tag);
+    }
+    EXPECT_TRUE(database.Compact(std::chrono::milliseconds(100)));
+    EXPECT_EQ(query.archetypes().size(), 1);
+    EXPECT_EQ(query.size(), 5000);
+
+    // Retired archetypes are recreated on demand
+    for (size_t i = 0; i < 100; ++i) {
+        entities[i].AddComponent(tag);
+    }
+    EXPECT_EQ(query.archetypes().size(), 2);
+    EXPECT_EQ(query.size(), 5000);
+
+    // Chunks of destroyed entities are returned to the OS
+    database.DestroyAll(query);
+    EXPECT_TRUE(database.Compact(std::chrono::milliseconds(100)));
+    EXPECT_EQ(query.archetypes().size(), 0);
+    EXPECT_EQ(database.Trim(), 0);
+
+    // No budget makes no progress
+    database.GetArchetype(compArr, 1);
+    EXPECT_FALSE(database.Compact(std::chrono::microseconds(0)));
+    EXPECT_EQ(query.archetypes().size(), 1);
+}
+
+TEST(ECDB, CompactPinned) {
+    Deep::ECRegistry registry;
+    Deep::ECDB gameplay{ &registry };
+    Deep::ECDB physics{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId body = registry.RegisterComponent<Component>();
+    Deep::ComponentId shared = registry.RegisterSharedComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ComponentId taggedArr[] = { comp, tag };
+    Deep::ComponentId bodyArr[] = { body };
+
+    // The destination archetype of a link is kept whilst no source entities match
+    Deep::ECDB::Query& source = gameplay.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(comp));
+    Deep::ECDB::Query& bodies = physics.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(body));
+    {
+        Deep::ECDBLink link{ &gameplay, &source, &physics, &physics.GetArchetype(bodyArr, 1) };
+        EXPECT_FALSE(link.Update());
+
+        EXPECT_TRUE(physics.Compact(std::chrono::milliseconds(100)));
+        EXPECT_EQ(bodies.archetypes().size(), 1);
+
+        gameplay.GetArchetype(compArr, 1).CreateEntities(10);
+        EXPECT_TRUE(link.Update());
+        EXPECT_EQ(bodies.size(), 10);
+    }
+
+    // Archetypes of pending commands are kept until playback
+    Deep::ECDB::Query& tagged = gameplay.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(tag));
+    {
+        Deep::ECDB::CommandBuffer buffer{ &gameplay };
+        buffer.Entity(&gameplay.GetArchetype(taggedArr, 2));
+
+        EXPECT_TRUE(gameplay.Compact(std::chrono::milliseconds(100)));
+        EXPECT_EQ(tagged.archetypes().size(), 1);
+
+        gameplay.Playback(buffer);
+        EXPECT_EQ(tagged.size(), 1);
+    }
+    gameplay.DestroyAll(tagged);
+    EXPECT_TRUE(gameplay.Compact(std::chrono::milliseconds(100)));
+    EXPECT_EQ(tagged.archetypes().size(), 0);
+
+    // Edges of shared components are unlinked when either end is retired
+    Deep::Entt entt = gameplay.Entity().AddComponent(comp).AddComponent(tag);
+    entt.SetSharedComponent(shared, Component{ 1 });
+    entt.RemoveComponent(shared);
+    EXPECT_TRUE(gameplay.Compact(std::chrono::milliseconds(100)));
+    EXPECT_EQ(tagged.archetypes().size(), 1);
+
+    entt.SetSharedComponent(shared, Component{ 1 });
+    entt.RemoveComponent(shared);
+    entt.SetSharedComponent(shared, Component{ 1 });
+    EXPECT_TRUE(gameplay.Compact(std::chrono::milliseconds(100)));
+    EXPECT_EQ(tagged.archetypes().size(), 1);
+
+    entt.RemoveComponent(shared);
+    EXPECT_TRUE(gameplay.Compact(std::chrono::milliseconds(100)));
+    EXPECT_EQ(tagged.archetypes().size(), 1);
+    EXPECT_EQ(tagged.size(), 1);
+    EXPECT_FALSE(tagged.archetypes()[0]->description.HasComponent(shared));
+}
+
+struct Position {
+    float x;
+    float y;
+    float z;
+};
+
+TEST(ECDB, LanedComponent) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId position = registry.RegisterLanedComponent<Position>(8);
+    Deep::ComponentId velocity = registry.RegisterLanedComponent<Position>(8);
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ComponentId compArr[] = { comp, position, velocity };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 3);
+
+    Position zero{ 0, 0, 0 };
+    Position one{ 1, 2, 3 };
+    const void* prototype[] = { nullptr, &zero, &one };
+    std::vector<Deep::Entt> entities = arch.CreateEntities(1000, prototype);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        arch.WriteComponent(entities[i], position, Position{ static_cast<float>(i), 0, -static_cast<float>(i) });
+    }
+
+    // Integrate positions a block of 8 entities at a time
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(position).With(velocity));
+    Deep::ComponentId components[] = { position, velocity };
+    query.ForEachChunk(components, 2,
+                       [](const Deep::ECDB::Archetype* archetype, Deep::ECDB::Archetype::Chunk* chunk, size_t size,
+                          const Deep::ECDB::Archetype::ComponentOffset* offsets) {
+                           auto pos = archetype->GetLaneColumn<float, 8>(chunk, offsets[0], size);
+                           auto vel = archetype->GetLaneColumn<const float, 8>(chunk, offsets[1], size);
+                           for (size_t block = 0; block < pos.NumBlocks(); ++block) {
+                               for (size_t field = 0; field < 3; ++field) {
+#ifdef DEEP_USE_AVX2
+                                   __m256 sum = _mm256_add_ps(pos.Load(block, field), vel.Load(block, field));
+                                   pos.Store(block, field, sum);
+#else
+                                   for (size_t lane = 0; lane < 8; ++lane) {
+                                       pos.GetLane(block, field)[lane] += vel.GetLane(block, field)[lane];
+                                   }
+#endif
+                               }
+                           }
+                       });
+
+    // Laned components are carried over when moving entities and when filling the gap of destroyed entities
+    for (size_t i = 0; i < 100; ++i) {
+        entities[i].AddComponent(tag);
+    }
+    for (size_t i = 100; i < 200; ++i) {
+        entities[i].Destroy();
+    }
+
+    Deep::ECDB::Archetype* tagged = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(tag)).archetypes()[0];
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (i >= 100 && i < 200) continue;
+
+        Deep::ECDB::Archetype* archetype = i < 100 ? tagged : &arch;
+        Position value = archetype->ReadComponent<Position>(entities[i], position);
+        EXPECT_EQ(value.x, static_cast<float>(i) + 1);
+        EXPECT_EQ(value.y, 2);
+        EXPECT_EQ(value.z, -static_cast<float>(i) + 3);
+    }
+}
+
+TEST(ECDB, View) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId other = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ComponentId compArr[] = { comp, other };
+    std::vector<Deep::Entt> entities = database.GetArchetype(compArr, 2).CreateEntities(5000);
+    for (size_t i = 0; i < 100; ++i) {
+        entities[i].AddComponent(tag);
+    }
+
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(comp).With(other));
+    Deep::ECDB::View<Component, Component> view{ query, { comp, other } };
+
+    size_t count = 0;
+    view.ForEachChunk([&count](size_t size, Component* Deep_Restrict a, Component* Deep_Restrict b) {
+        for (size_t i = 0; i < size; ++i) {
+            a[i].a = static_cast<int>(i);
+            b[i].a = 2 * static_cast<int>(i);
+        }
+        count += size;
+    });
+    EXPECT_EQ(count, 5000);
+
+    view.ForEach([](Component& a, Component& b) { a.a += b.a; });
+
+    int sum = 0;
+    Deep::ECDB::View<const Component> readView{ query, { comp } };
+    readView.ForEach([&sum](const Component& a) { sum += a.a; });
+
+    int expected = 0;
+    readView.ForEachChunk([&expected](size_t size, const Component* Deep_Restrict) {
+        for (size_t i = 0; i < size; ++i) {
+            expected += 3 * static_cast<int>(i);
+        }
+    });
+    EXPECT_EQ(sum, expected);
+
+    // Changed filter
+    Deep::ECDB::Query& changed = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.Changed(comp));
+    Deep::ECDB::View<const Component> changedView{ changed, { comp } };
+
+    uint64 version = database.GetVersion();
+    database.Tick();
+    count = 0;
+    changedView.ForEachChunk([&count](size_t size, const Component* Deep_Restrict) { count += size; }, version);
+    EXPECT_EQ(count, 0);
+
+    database.GetArchetype(compArr, 2).GetComponent<Component>(entities[500], comp).a = 0;
+    changedView.ForEachChunk([&count](size_t size, const Component* Deep_Restrict) { count += size; }, version);
+    EXPECT_GT(count, 0);
+    EXPECT_LT(count, 5000);
+}
+
+TEST(ECDB, ComponentMap) {
+    Deep::ComponentMap<int> map;
+    EXPECT_EQ(map.Find(3), nullptr);
+
+    // Dense ids
+    for (Deep::ComponentId id = 10; id < 20; ++id) {
+        map.Insert(id, static_cast<int>(id) * 2);
+    }
+    EXPECT_EQ(*map.Find(15), 30);
+    EXPECT_EQ(map.Find(9), nullptr);
+    EXPECT_EQ(map.Find(20), nullptr);
+
+    EXPECT_TRUE(map.Erase(15));
+    EXPECT_FALSE(map.Erase(15));
+    EXPECT_EQ(map.Find(15), nullptr);
+    EXPECT_EQ(*map.Find(16), 32);
+    EXPECT_EQ(map.size(), 9);
+
+    // Sparse ids fall back to a binary search
+    map.Insert(5000, 1);
+    EXPECT_EQ(*map.Find(5000), 1);
+    EXPECT_EQ(*map.Find(10), 20);
+    EXPECT_EQ(map.Find(4999), nullptr);
+
+    // Archetypes with sparse components
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    for (size_t i = 0; i < 200; ++i) {
+        registry.RegisterComponent<Component>();
+    }
+    Deep::ComponentId other = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::Entt entt = database.Entity();
+    entt.AddComponent(comp).AddComponent(other).AddComponent(tag);
+
+    Deep::ComponentId compArr[] = { comp, other, tag };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 3);
+    EXPECT_EQ(arch.size(), 1);
+    arch.GetComponent<Component>(entt, comp).a = 1;
+    arch.GetComponent<Component>(entt, other).a = 2;
+
+    entt.RemoveComponent(comp);
+    Deep::ComponentId otherArr[] = { other, tag };
+    Deep::ECDB::Archetype& otherArch = database.GetArchetype(otherArr, 2);
+    EXPECT_EQ(otherArch.size(), 1);
+    EXPECT_EQ(otherArch.GetComponent<Component>(entt, other).a, 2);
+
+    // Edges lead back to the same archetype
+    entt.AddComponent(comp);
+    EXPECT_EQ(arch.size(), 1);
+    EXPECT_EQ(arch.GetComponent<Component>(entt, other).a, 2);
+}
+
+TEST(ArchetypeBitField, Spill) {
+    Deep::ECRegistry registry;
+    Deep::ArchetypeBitField a{ &registry };
+    Deep::ArchetypeBitField b{ &registry };
+
+    for (size_t i = 0; i < 300; ++i) {
+        registry.RegisterComponent(1, 1);
+    }
+
+    // Components beyond the inline bits spill to the heap
+    a.AddComponent(3).AddComponent(290);
+    b.AddComponent(3);
+    EXPECT_TRUE(a.HasComponent(290));
+    EXPECT_FALSE(b.HasComponent(290));
+    EXPECT_NE(a, b);
+
+    EXPECT_TRUE(a.HasAll(b));
+    EXPECT_FALSE(b.HasAll(a));
+
+    Deep::ArchetypeBitField c{ &registry };
+    c.AddComponent(290);
+    EXPECT_TRUE(a.HasAny(c));
+    EXPECT_FALSE(b.HasAny(c));
+
+    // Empty spilled words do not affect equality or the hash
+    a.RemoveComponent(290);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(std::hash<Deep::ArchetypeBitField>{}(a), std::hash<Deep::ArchetypeBitField>{}(b));
+
+    c.RemoveComponent(290);
+    EXPECT_TRUE(c.IsEmpty());
+    EXPECT_FALSE(a.IsEmpty());
+
+    // Copies keep the cached hash
+    Deep::ArchetypeBitField d{ a };
+    EXPECT_EQ(std::hash<Deep::ArchetypeBitField>{}(a), std::hash<Deep::ArchetypeBitField>{}(d));
+}
+
+TEST(ECDB, EntityHandle) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+
+    EXPECT_LE(sizeof(Deep::EntityHandle), 8);
+    EXPECT_TRUE(Deep::EntityHandle{}.IsNull());
+    EXPECT_FALSE(database.IsValid(Deep::EntityHandle{}));
+
+    std::vector<Deep::Entt> entities = arch.CreateEntities(3000);
+    Deep::EntityHandle handle = entities[2000].GetHandle();
+    EXPECT_TRUE(database.IsValid(handle));
+    EXPECT_EQ(database.GetHandle(database.GetEntity(handle)), handle);
+
+    arch.GetComponent<Component>(database.GetEntity(handle), comp).a = 5;
+    EXPECT_EQ(arch.GetComponent<Component>(entities[2000], comp).a, 5);
+
+    // Recycled slots do not alias stale handles
+    entities[2000].Destroy();
+    EXPECT_FALSE(database.IsValid(handle));
+
+    Deep::EntityHandle recycled = database.Entity().GetHandle();
+    EXPECT_EQ(recycled.GetIndex(), handle.GetIndex());
+    EXPECT_NE(recycled, handle);
+    EXPECT_TRUE(database.IsValid(recycled));
+    EXPECT_FALSE(database.IsValid(handle));
+
+    // Handles of entities alive when forking remain valid after restoring
+    Deep::EntityHandle kept = entities[10].GetHandle();
+    Deep::ECDB::ForkState* fork = database.Fork();
+
+    entities[10].Destroy();
+    Deep::EntityHandle created = database.Entity().GetHandle();
+    EXPECT_FALSE(database.IsValid(kept));
+
+    database.Restore(fork);
+    EXPECT_TRUE(database.IsValid(kept));
+    EXPECT_TRUE(database.IsValid(recycled));
+    EXPECT_FALSE(database.IsValid(created));
+    EXPECT_EQ(arch.size(), 2999);
+
+    database.Release(fork);
+}
+
+TEST(ECDB, SparseComponent) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+    Deep::ComponentId hit = registry.RegisterSparseComponent<Component>();
+    EXPECT_TRUE(Deep::ECRegistry::IsSparse(hit));
+    EXPECT_FALSE(Deep::ECRegistry::IsComponent(hit));
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+    std::vector<Deep::Entt> entities = arch.CreateEntities(1000);
+    for (size_t i = 0; i < 10; ++i) {
+        entities[i].AddComponent(tag);
+    }
+
+    // Adding / removing sparse components does not move the entity
+    for (size_t i = 0; i < 1000; i += 100) {
+        entities[i].AddComponent(hit);
+        database.GetSparseComponent<Component>(entities[i], hit)->a = static_cast<int>(i);
+    }
+    EXPECT_EQ(arch.size(), 990);
+    EXPECT_EQ(database.GetSparseComponent(entities[1], hit), nullptr);
+    EXPECT_EQ(database.GetSparseComponent<Component>(entities[500], hit)->a, 500);
+
+    entities[500].RemoveComponent(hit);
+    EXPECT_EQ(database.GetSparseComponent(entities[500], hit), nullptr);
+    EXPECT_EQ(database.GetSparseComponent<Component>(entities[900], hit)->a, 900);
+    EXPECT_EQ(arch.size(), 990);
+
+    // Queries join the sparse set
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(comp).Without(tag));
+    int sum = 0;
+    size_t count = 0;
+    query.Join<Component>(hit, [&](Deep::ECDB::Archetype& archetype, Deep::Entt entity, Component& value) {
+        EXPECT_EQ(&archetype, &arch);
+        archetype.GetComponent<Component>(entity, comp).a = value.a;
+        sum += value.a;
+        ++count;
+    });
+    EXPECT_EQ(count, 8); // Excludes entities[0] (tagged) and entities[500] (removed)
+    EXPECT_EQ(sum, 100 + 200 + 300 + 400 + 600 + 700 + 800 + 900);
+    EXPECT_EQ(arch.GetComponent<Component>(entities[300], comp).a, 300);
+
+    // Command buffers
+    Deep::ECDB::CommandBuffer buffer{ &database };
+    buffer.AddComponent(entities[1], hit);
+    buffer.SetComponent(entities[1], hit, Component{ 7 });
+    buffer.RemoveComponent(entities[100], hit);
+    database.Playback(buffer);
+    EXPECT_EQ(database.GetSparseComponent<Component>(entities[1], hit)->a, 7);
+    EXPECT_EQ(database.GetSparseComponent(entities[100], hit), nullptr);
+
+    // Forks restore sparse components
+    Deep::ECDB::ForkState* fork = database.Fork();
+    entities[1].RemoveComponent(hit);
+    entities[2].AddComponent(hit);
+    database.Restore(fork);
+    EXPECT_EQ(database.GetSparseComponent<Component>(entities[1], hit)->a, 7);
+    EXPECT_EQ(database.GetSparseComponent(entities[2], hit), nullptr);
+    database.Release(fork);
+
+    // Destroying an entity removes its sparse components
+    entities[200].Destroy();
+    Deep::Entt recycled = database.Entity();
+    EXPECT_EQ(database.GetSparseComponent(recycled, hit), nullptr);
+}
+
+// Returns the handles of the entities of `archetypes` in chunk order, as if the archetypes were concatenated
+static std::vector<Deep::EntityHandle> GetOrder(Deep::ECDB& database,
+                                                const std::vector<Deep::ECDB::Archetype*>& archetypes) {
+    std::vector<Deep::EntityHandle> order;
+    for (Deep::ECDB::Archetype* archetype : archetypes) {
+        for (Deep::ECDB::Archetype::Chunk* chunk = archetype->chunks(); chunk != nullptr;
+             chunk = archetype->GetNextChunk(chunk)) {
+            const Deep::ECDB::Archetype::Metadata* metadata = Deep::ECDB::Archetype::GetMetaList(chunk);
+            for (size_t i = 0; i < archetype->GetChunkSize(chunk); ++i) {
+                order.push_back(database.GetHandle(metadata[i].entt));
+            }
+        }
+    }
+    return order;
+}
+
+TEST(ECDB, SnapshotSparseComponent) {
+    Deep::ECRegistry registry;
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId hit = registry.RegisterSparseComponent<Component>();
+
+    Deep::ComponentId compArr[] = { comp };
+
+    std::vector<uint8> snapshot;
+    {
+        Deep::ECDB database{ &registry };
+
+        // Destroyed entities leave gaps in the entity lookup, such that slots do not match snapshot indices
+        std::vector<Deep::Entt> entities = database.GetArchetype(compArr, 1).CreateEntities(1000);
+        for (size_t i = 0; i < entities.size(); ++i) {
+            database.GetArchetype(compArr, 1).GetComponent<Component>(entities[i], comp).a = static_cast<int>(i);
+            if (i % 7 == 0) {
+                entities[i].AddComponent(hit);
+                database.GetSparseComponent<Component>(entities[i], hit)->a = static_cast<int>(i) * 2;
+            }
+        }
+        for (size_t i = 0; i < entities.size(); i += 10) {
+            entities[i].Destroy();
+        }
+
+        database.SaveSnapshot(snapshot);
+    }
+
+    Deep::ECDB database{ &registry };
+    database.Entity().AddComponent(hit);
+    EXPECT_FALSE(database.LoadSnapshot(snapshot.data(), snapshot.size() - 1));
+    ASSERT_TRUE(database.LoadSnapshot(snapshot.data(), snapshot.size()));
+
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+    EXPECT_EQ(arch.size(), 900);
+
+    size_t numHits = 0;
+    for (Deep::ECDB::Archetype::Chunk* c = arch.chunks(); c != nullptr; c = arch.GetNextChunk(c)) {
+        const Deep::ECDB::Archetype::Metadata* metadata = Deep::ECDB::Archetype::GetMetaList(c);
+        for (size_t i = 0; i < arch.GetChunkSize(c); ++i) {
+            Deep::Entt entt{ &database, metadata[i].entt };
+            int value = arch.GetComponent<const Component>(entt, comp).a;
+
+            const Component* sparse = database.GetSparseComponent<Component>(entt, hit);
+            if (value % 7 != 0) {
+                EXPECT_EQ(sparse, nullptr);
+                continue;
+            }
+
+            ASSERT_NE(sparse, nullptr);
+            EXPECT_EQ(sparse->a, value * 2);
+            ++numHits;
+        }
+    }
+    EXPECT_EQ(numHits, 143 - 15);
+}
+
+TEST(ECDB, Link) {
+    Deep::ECRegistry registry;
+    Deep::ECDB gameplay{ &registry };
+    Deep::ECDB physics{ &registry, 1024 }; // Different chunk size, such that chunks do not line up
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId body = registry.RegisterLanedComponent<Component, int>(4);
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ComponentId taggedArr[] = { comp, tag };
+    Deep::ECDB::Archetype& arch = gameplay.GetArchetype(compArr, 1);
+    Deep::ECDB::Archetype& tagged = gameplay.GetArchetype(taggedArr, 2);
+
+    std::vector<Deep::Entt> entities = arch.CreateEntities(300);
+    std::vector<Deep::EntityHandle> handles;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        arch.GetComponent<Component>(entities[i], comp).a = static_cast<int>(i);
+        handles.push_back(entities[i].GetHandle());
+    }
+    for (size_t i = 0; i < entities.size(); i += 3) {
+        entities[i].AddComponent(tag);
+    }
+
+    Deep::ECDB::Query& query = gameplay.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(comp));
+    Deep::ComponentId bodyArr[] = { comp, body };
+    Deep::ECDB::Archetype& bodies = physics.GetArchetype(bodyArr, 2);
+
+    Deep::ECDBLink link{ &gameplay, &query, &physics, &bodies };
+    link.Sync(comp, comp).Sync(comp, body);
+
+    // Destination entities follow the order of the source entities
+    auto check = [&]() {
+        std::vector<Deep::EntityHandle> source = GetOrder(gameplay, query.archetypes());
+        std::vector<Deep::EntityHandle> destination = GetOrder(physics, { &bodies });
+        ASSERT_EQ(source.size(), destination.size());
+        for (size_t i = 0; i < source.size(); ++i) {
+            EXPECT_EQ(link.GetLinked(source[i]), destination[i]);
+        }
+    };
+
+    EXPECT_TRUE(link.Update());
+    EXPECT_FALSE(link.Update());
+    EXPECT_EQ(link.size(), 300);
+    check();
+
+    link.Push();
+    for (size_t i = 0; i < entities.size(); ++i) {
+        Deep::Entt linked = physics.GetEntity(link.GetLinked(handles[i]));
+        EXPECT_EQ(bodies.GetComponent<Component>(linked, comp).a, static_cast<int>(i));
+        EXPECT_EQ(bodies.ReadComponent<Component>(linked, body).a, static_cast<int>(i));
+        bodies.WriteComponent(linked, body, Component{ static_cast<int>(i) + 1000 });
+    }
+
+    // Pairs are copied in the order they were added, so `body` is copied back last
+    link.Pull();
+    for (size_t i = 0; i < entities.size(); ++i) {
+        Deep::ECDB::Archetype& source = i % 3 == 0 ? tagged : arch;
+        EXPECT_EQ(source.GetComponent<Component>(entities[i], comp).a, static_cast<int>(i) + 1000);
+    }
+
+    // Structural changes to the source reorder the destination
+    for (size_t i = 0; i < entities.size(); i += 6) {
+        entities[i].RemoveComponent(tag);
+    }
+    for (size_t i = 0; i < entities.size(); i += 5) {
+        entities[i].Destroy();
+    }
+    Deep::Entt created = arch.Entity();
+    arch.GetComponent<Component>(created, comp).a = -1;
+
+    EXPECT_TRUE(link.Update());
+    EXPECT_EQ(link.size(), 300 - 60 + 1);
+    check();
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        if (i % 5 == 0) {
+            EXPECT_TRUE(link.GetLinked(handles[i]).IsNull());
+            continue;
+        }
+
+        // Destination data is carried along when reordering
+        Deep::Entt linked = physics.GetEntity(link.GetLinked(handles[i]));
+        EXPECT_EQ(bodies.ReadComponent<Component>(linked, body).a, static_cast<int>(i) + 1000);
+    }
+
+    link.Push();
+    Deep::Entt linked = physics.GetEntity(link.GetLinked(created.GetHandle()));
+    EXPECT_EQ(bodies.GetComponent<Component>(linked, comp).a, -1);
+    EXPECT_EQ(bodies.ReadComponent<Component>(linked, body).a, -1);
+}
+
+TEST(ECDB, Events) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    // Nothing is recorded unless enabled
+    database.Entity();
+    EXPECT_TRUE(database.GetCreatedEvents().empty());
+
+    database.SetEventRecording(true);
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+    std::vector<Deep::Entt> entities = arch.CreateEntities(100);
+    Deep::Entt entity = database.Entity();
+    ASSERT_EQ(database.GetCreatedEvents().size(), 101);
+    EXPECT_EQ(database.GetCreatedEvents()[0], entities[0].GetHandle());
+    EXPECT_EQ(database.GetCreatedEvents()[100], entity.GetHandle());
+    EXPECT_TRUE(database.GetMovedEvents().empty());
+
+    entity.AddComponent(comp);
+    ASSERT_EQ(database.GetMovedEvents().size(), 1);
+    EXPECT_EQ(database.GetMovedEvents()[0].entity, entity.GetHandle());
+    EXPECT_EQ(database.GetMovedEvents()[0].from, &database.GetRootArchetype());
+    EXPECT_EQ(database.GetMovedEvents()[0].to, &arch);
+
+    // Bulk moves record an event per entity
+    database.ClearEvents();
+    database.AddComponent(arch, tag);
+    EXPECT_EQ(database.GetMovedEvents().size(), 101);
+    EXPECT_TRUE(database.GetCreatedEvents().empty());
+
+    Deep::EntityHandle handle = entities[5].GetHandle();
+    entities[5].Destroy();
+    ASSERT_EQ(database.GetDestroyedEvents().size(), 1);
+    EXPECT_EQ(database.GetDestroyedEvents()[0], handle);
+
+    database.ClearEvents();
+    EXPECT_TRUE(database.GetCreatedEvents().empty());
+    EXPECT_TRUE(database.GetDestroyedEvents().empty());
+    EXPECT_TRUE(database.GetMovedEvents().empty());
+
+    // Restoring a fork clears the logs
+    Deep::ECDB::ForkState* fork = database.Fork();
+    database.Entity();
+    database.Restore(fork);
+    database.Release(fork);
+    EXPECT_TRUE(database.GetCreatedEvents().empty());
+}
+
+struct Bounds {
+    int min;
+    int max;
+};
+
+TEST(ECDB, ChunkComponent) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry, 1024 };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId bounds = registry.RegisterChunkComponent<Bounds>();
+    EXPECT_TRUE(Deep::ECRegistry::IsChunk(bounds));
+    EXPECT_FALSE(Deep::ECRegistry::IsComponent(bounds));
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& plain = database.GetArchetype(compArr, 1);
+    std::vector<Deep::Entt> entities = plain.CreateEntities(1000);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        plain.GetComponent<Component>(entities[i], comp).a = static_cast<int>(i);
+    }
+
+    // Adding a chunk component moves the entities into chunks that hold the chunk component
+    database.AddComponent(plain, bounds);
+    Deep::ComponentId boundsArr[] = { comp, bounds };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(boundsArr, 2);
+    EXPECT_EQ(arch.size(), 1000);
+    EXPECT_FALSE(arch.SharesLayout(plain));
+
+    size_t numChunks = 0;
+    for (Deep::ECDB::Archetype::Chunk* chunk = arch.chunks(); chunk != nullptr; chunk = arch.GetNextChunk(chunk)) {
+        const Bounds& value = arch.GetChunkComponent<const Bounds>(chunk, bounds);
+        EXPECT_EQ(value.min, 0);
+        EXPECT_EQ(value.max, 0);
+        ++numChunks;
+    }
+    EXPECT_GT(numChunks, 2);
+
+    // Maintain the bounds of chunks whose values have changed
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(bounds).Changed(comp));
+    auto update = [&](uint64 sinceVersion) {
+        size_t updated = 0;
+        query.ForEachChunk(
+            &comp, 1,
+            [&](const Deep::ECDB::Archetype* archetype, Deep::ECDB::Archetype::Chunk* chunk, size_t size,
+                const Deep::ECDB::Archetype::ComponentOffset* offsets) {
+                const Component* values = archetype->GetCompList<const Component>(chunk, offsets[0]);
+                Bounds& value = archetype->GetChunkComponent<Bounds>(chunk, bounds);
+                value = { values[0].a, values[0].a };
+                for (size_t i = 1; i < size; ++i) {
+                    value.min = std::min(value.min, values[i].a);
+                    value.max = std::max(value.max, values[i].a);
+                }
+                ++updated;
+            },
+            sinceVersion);
+        return updated;
+    };
+    EXPECT_EQ(update(0), numChunks);
+
+    // Chunks are rejected by their bounds without touching their columns
+    Deep::ECDB::Archetype::ChunkFilter filter = [&](const Deep::ECDB::Archetype* archetype,
+                                                    Deep::ECDB::Archetype::Chunk* chunk) {
+        return archetype->GetChunkComponent<const Bounds>(chunk, bounds).max >= 900;
+    };
+    size_t visited = 0;
+    size_t count = 0;
+    query.ForEachChunk(
+        &comp, 1,
+        [&](const Deep::ECDB::Archetype* archetype, Deep::ECDB::Archetype::Chunk* chunk, size_t size,
+            const Deep::ECDB::Archetype::ComponentOffset* offsets) {
+            const Component* values = archetype->GetCompList<const Component>(chunk, offsets[0]);
+            for (size_t i = 0; i < size; ++i) {
+                if (values[i].a >= 900) ++count;
+            }
+            ++visited;
+        },
+        0, filter);
+    EXPECT_EQ(count, 100);
+    EXPECT_LT(visited, numChunks);
+
+    size_t viewCount = 0;
+    Deep::ECDB::View<const Component>{ query, { comp } }.ForEach(
+        [&](const Component& value) {
+            if (value.a >= 900) ++viewCount;
+        },
+        0, filter);
+    EXPECT_EQ(viewCount, 100);
+
+    // Only changed chunks need to be recomputed
+    uint64 version = database.Tick();
+    arch.GetComponent<Component>(entities[0], comp).a = 5000;
+    EXPECT_EQ(update(version - 1), 1);
+    count = 0;
+    query.ForEachChunk(
+        &comp, 1,
+        [&](const Deep::ECDB::Archetype*, Deep::ECDB::Archetype::Chunk*, size_t,
+            const Deep::ECDB::Archetype::ComponentOffset*) { ++count; },
+        0, filter);
+    EXPECT_GE(count, 2);
+}
+
+TEST(ECDB, ChunkComponentRollback) {
+    Deep::ECRegistry registry;
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId bounds = registry.RegisterChunkComponent<Bounds>();
+    Deep::ComponentId boundsArr[] = { comp, bounds };
+
+    // Chunk components hold the index of their chunk
+    auto expectBounds = [bounds](const Deep::ECDB::Archetype& arch, size_t numChunks) {
+        size_t i = 0;
+        for (Deep::ECDB::Archetype::Chunk* chunk = arch.chunks(); chunk != nullptr; chunk = arch.GetNextChunk(chunk)) {
+            const Bounds& value = arch.GetChunkComponent<const Bounds>(chunk, bounds);
+            EXPECT_EQ(value.min, static_cast<int>(i));
+            EXPECT_EQ(value.max, static_cast<int>(i));
+            ++i;
+        }
+        EXPECT_EQ(i, numChunks);
+    };
+
+    Deep::ECDB database{ &registry, 1024 };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(boundsArr, 2);
+    arch.CreateEntities(1000);
+
+    size_t numChunks = 0;
+    for (Deep::ECDB::Archetype::Chunk* chunk = arch.chunks(); chunk != nullptr; chunk = arch.GetNextChunk(chunk)) {
+        arch.GetChunkComponent<Bounds>(chunk, bounds) = { static_cast<int>(numChunks), static_cast<int>(numChunks) };
+        ++numChunks;
+    }
+    EXPECT_GT(numChunks, 2);
+
+    // Writes to chunk components after the fork are undone by restoring
+    Deep::ECDB::ForkState* fork = database.Fork();
+    Deep::ECDB::Archetype::Chunk* chunk = arch.GetNextChunk(arch.chunks());
+    arch.GetChunkComponent<Bounds>(chunk, bounds) = { -1, -1 };
+    *static_cast<Bounds*>(arch.GetChunkComponent(arch.chunks(), bounds)) = { -1, -1 };
+
+    database.Restore(fork);
+    expectBounds(arch, numChunks);
+    database.Release(fork);
+
+    // Chunk components are part of snapshots
+    std::vector<uint8> snapshot;
+    database.SaveSnapshot(snapshot);
+
+    Deep::ECDB loaded{ &registry, 1024 };
+    ASSERT_TRUE(loaded.LoadSnapshot(snapshot.data(), snapshot.size()));
+    expectBounds(loaded.GetArchetype(boundsArr, 2), numChunks);
+}
+
+TEST(ECDB, Prefab) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId other = registry.RegisterComponent<Component>();
+    Deep::ComponentId laned = registry.RegisterLanedComponent<Bounds, int>(4);
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ECDB::ArchetypeDesc description{ &registry };
+    description.AddComponent(comp).AddComponent(other).AddComponent(laned).AddComponent(tag);
+
+    Deep::ECDB::Prefab& prefab = database.CreatePrefab(description);
+    prefab.SetComponent(comp, Component{ 7 }).SetComponent(laned, Bounds{ -1, 1 });
+    EXPECT_EQ(prefab.GetComponent<Component>(comp).a, 7);
+    EXPECT_EQ(prefab.GetComponent<Component>(other).a, 0);
+
+    std::vector<Deep::Entt> entities = prefab.Instantiate(5000);
+    Deep::Entt single = prefab.Instantiate();
+    entities.push_back(single);
+
+    Deep::ECDB::Archetype& arch = *prefab.archetype;
+    EXPECT_EQ(arch.size(), 5001);
+    for (Deep::Entt entity : entities) {
+        EXPECT_EQ(arch.GetComponent<Component>(entity, comp).a, 7);
+        EXPECT_EQ(arch.GetComponent<Component>(entity, other).a, 0);
+        Bounds value = arch.ReadComponent<Bounds>(entity, laned);
+        EXPECT_EQ(value.min, -1);
+        EXPECT_EQ(value.max, 1);
+    }
+
+    // Changing the defaults only affects later instances
+    prefab.SetComponent(comp, Component{ 8 });
+    Deep::Entt later = prefab.Instantiate();
+    EXPECT_EQ(arch.GetComponent<Component>(later, comp).a, 8);
+    EXPECT_EQ(arch.GetComponent<Component>(entities[0], comp).a, 7);
+
+    // The archetype of a prefab is not retired whilst empty
+    database.DestroyAll(arch);
+    while (!database.Compact(std::chrono::microseconds{ 1000 })) {}
+    EXPECT_EQ(&database.GetArchetype(description), &arch);
+    EXPECT_EQ(arch.GetComponent<Component>(prefab.Instantiate(), comp).a, 8);
+}
+
+TEST(ECDB, ForEachChunkParallel) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+    Deep::JobSystem jobSystem{ 4, 1024, 16 };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+    Deep::ComponentId tag = registry.RegisterTag();
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+    Deep::ComponentId taggedArr[] = { comp, tag };
+    Deep::ECDB::Archetype& tagged = database.GetArchetype(taggedArr, 2);
+
+    // Each entity stores its own index such that visits can be counted per entity
+    const size_t numEntities = 10000;
+    std::vector<Deep::Entt> entities = arch.CreateEntities(numEntities);
+    std::vector<Deep::Entt> taggedEntities = tagged.CreateEntities(numEntities / 2);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        arch.WriteComponent(entities[i], comp, Component{ static_cast<int>(i) });
+    }
+    for (size_t i = 0; i < taggedEntities.size(); ++i) {
+        tagged.WriteComponent(taggedEntities[i], comp, Component{ static_cast<int>(numEntities + i) });
+    }
+
+    size_t numChunks = 0;
+    for (Deep::ECDB::Archetype::Chunk* chunk = arch.chunks(); chunk != nullptr; chunk = arch.GetNextChunk(chunk)) {
+        ++numChunks;
+    }
+    EXPECT_GT(numChunks, 4);
+
+    std::vector<std::atomic<int>> visits(numEntities + numEntities / 2);
+    auto visit = [&visits](const Deep::ECDB::Archetype* archetype, Deep::ECDB::Archetype::Chunk* chunk, size_t size,
+                           const Deep::ECDB::Archetype::ComponentOffset* offsets) {
+        const Component* components = archetype->GetCompList<const Component>(chunk, offsets[0]);
+        for (size_t i = 0; i < size; ++i) {
+            ++visits[components[i].a];
+        }
+    };
+    auto expectVisits = [&visits](size_t begin, size_t end, int count) {
+        for (size_t i = begin; i < end; ++i) {
+            ASSERT_EQ(visits[i].load(), count) << "entity " << i;
+        }
+    };
+
+    // Fewer jobs than chunks, chunks are split into ranges
+    arch.ForEachChunkParallel(&jobSystem, compArr, 1, visit, 3);
+    expectVisits(0, numEntities, 1);
+    expectVisits(numEntities, visits.size(), 0);
+
+    // More jobs than chunks, atmost 1 job per chunk
+    arch.ForEachChunkParallel(&jobSystem, compArr, 1, visit, 256);
+    expectVisits(0, numEntities, 2);
+    expectVisits(numEntities, visits.size(), 0);
+
+    // Queries iterate the chunks of all matching archetypes
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(comp));
+    query.ForEachChunkParallel(&jobSystem, compArr, 1, visit, 4);
+    expectVisits(0, numEntities, 3);
+    expectVisits(numEntities, visits.size(), 1);
+}
+
+TEST(ECDB, ForkParallel) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+    Deep::JobSystem jobSystem{ 4, 1024, 16 };
+
+    Deep::ComponentId comp = registry.RegisterComponent<Component>();
+
+    Deep::ComponentId compArr[] = { comp };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 1);
+
+    std::vector<Deep::Entt> entities = arch.CreateEntities(10000);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        arch.GetComponent<Component>(entities[i], comp).a = static_cast<int>(i);
+    }
+
+    Deep::ECDB::ForkState* fork = database.Fork();
+
+    // Chunks shared with the fork are preserved from the worker threads
+    arch.ForEachChunkParallel(
+        &jobSystem, compArr, 1,
+        [](const Deep::ECDB::Archetype* archetype, Deep::ECDB::Archetype::Chunk* chunk, size_t size,
+           const Deep::ECDB::Archetype::ComponentOffset* offsets) {
+            Component* components = archetype->GetCompList<Component>(chunk, offsets[0]);
+            for (size_t i = 0; i < size; ++i) {
+                components[i].a = -1;
+            }
+        },
+        16);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        ASSERT_EQ(arch.GetComponent<const Component>(entities[i], comp).a, -1) << "entity " << i;
+    }
+
+    database.Restore(fork);
+    for (size_t i = 0; i < entities.size(); ++i) {
+        ASSERT_EQ(arch.GetComponent<const Component>(entities[i], comp).a, static_cast<int>(i)) << "entity " << i;
+    }
+    database.Release(fork);
 }
\ No newline at end of file
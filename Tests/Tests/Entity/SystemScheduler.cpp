@@ -0,0 +1,102 @@
+#include "../pch.h"
+#include <Deep.h>
+#include <Deep/Entity.h>
+
+#include <atomic>
+
+struct Value {
+    int value;
+};
+
+TEST(SystemScheduler, Dependencies) {
+    Deep::ECRegistry registry;
+    Deep::ECDB database{ &registry };
+    Deep::JobSystem jobSystem{ 4, 1024, 16 };
+    Deep::SystemScheduler scheduler{ &database, &jobSystem };
+
+    Deep::ComponentId a = registry.RegisterComponent<Value>();
+    Deep::ComponentId b = registry.RegisterComponent<Value>();
+    Deep::ComponentId c = registry.RegisterComponent<Value>();
+
+    Deep::ComponentId compArr[] = { a, b, c };
+    Deep::ECDB::Archetype& arch = database.GetArchetype(compArr, 3);
+    arch.CreateEntities(1000);
+
+    Deep::ECDB::Query& query = database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.With(a).With(b).With(c));
+
+    // Each system accesses the components through a view matching the access it declares
+    Deep::ECDB::View<Value, const Value, const Value> writeAView{ query, { a, b, c } };
+    Deep::ECDB::View<const Value, Value, const Value> copyAToBView{ query, { a, b, c } };
+    Deep::ECDB::View<const Value, const Value, Value> writeCView{ query, { a, b, c } };
+    Deep::ECDB::View<const Value, const Value, const Value> readView{ query, { a, b, c } };
+
+    // Order in which the systems completed
+    std::atomic<int> counter{ 0 };
+    int order[5];
+
+    auto writeAFunction = [&](Deep::ECDB&) {
+        writeAView.ForEach([](Value& a, const Value&, const Value&) { a.value = 1; });
+        order[0] = counter++;
+    };
+    size_t writeA = scheduler.Register(Deep::SystemScheduler::SystemDesc{ &registry }.Write(a), writeAFunction);
+    size_t copyAToB = scheduler.Register(Deep::SystemScheduler::SystemDesc{ &registry }.Read(a).Write(b),
+                                         [&](Deep::ECDB&) {
+                                             copyAToBView.ForEach(
+                                                 [](const Value& a, Value& b, const Value&) { b.value = a.value + 1; });
+                                             order[1] = counter++;
+                                         });
+    size_t writeC = scheduler.Register(Deep::SystemScheduler::SystemDesc{ &registry }.Write(c),
+                                       [&](Deep::ECDB&) {
+                                           writeCView.ForEach(
+                                               [](const Value&, const Value&, Value& c) { c.value = 5; });
+                                           order[2] = counter++;
+                                       });
+    size_t readB = scheduler.Register(Deep::SystemScheduler::SystemDesc{ &registry }.Read(b),
+                                      [&](Deep::ECDB&) { order[3] = counter++; });
+    size_t exclusive = scheduler.Register(Deep::SystemScheduler::SystemDesc{ &registry }.Exclusive(),
+                                          [&](Deep::ECDB&) { order[4] = counter++; });
+
+    // Dependencies are derived from the declared access
+    EXPECT_TRUE(scheduler.GetDependencies(writeA).empty());
+    EXPECT_EQ(scheduler.GetDependencies(copyAToB), std::vector<size_t>{ writeA });
+    EXPECT_TRUE(scheduler.GetDependencies(writeC).empty());
+    EXPECT_EQ(scheduler.GetDependencies(readB), std::vector<size_t>{ copyAToB });
+
+    // Dependencies implied through other systems are not linked
+    EXPECT_EQ(scheduler.GetDependencies(exclusive), (std::vector<size_t>{ readB, writeC }));
+
+    for (int i = 0; i < 10; ++i) {
+        counter = 0;
+        scheduler.Run();
+        EXPECT_EQ(counter, 5);
+
+        EXPECT_LT(order[writeA], order[copyAToB]);
+        EXPECT_LT(order[copyAToB], order[readB]);
+        EXPECT_EQ(order[exclusive], 4);
+    }
+
+    int sum = 0;
+    readView.ForEach([&sum](const Value& a, const Value& b, const Value& c) { sum += a.value + b.value + c.value; });
+    EXPECT_EQ(sum, 1000 * (1 + 2 + 5));
+
+    // Systems only change the components they write
+    Deep::SystemScheduler onlyWriteA{ &database, &jobSystem };
+    onlyWriteA.Register(Deep::SystemScheduler::SystemDesc{ &registry }.Write(a), writeAFunction);
+
+    auto countChanged = [&](Deep::ComponentId component, uint64 sinceVersion) {
+        size_t count = 0;
+        database.GetQuery(Deep::ECDB::QueryDesc{ &registry }.Changed(component))
+            .ForEachChunk(nullptr, 0,
+                          [&count](const Deep::ECDB::Archetype*, Deep::ECDB::Archetype::Chunk*, size_t,
+                                   const Deep::ECDB::Archetype::ComponentOffset*) { ++count; },
+                          sinceVersion);
+        return count;
+    };
+
+    uint64 lastVersion = database.GetVersion();
+    database.Tick();
+    onlyWriteA.Run();
+    EXPECT_GT(countChanged(a, lastVersion), 0);
+    EXPECT_EQ(countChanged(b, lastVersion), 0);
+    EXPECT_EQ(countChanged(c, lastVersion), 0);
+}
\ No newline at end of file